@@ -18,10 +18,11 @@ inline void program_init(Parg& pg)
   pg.name("peaclock").version("0.4.3 (11.09.2020)");
   pg.description("A responsive and customizable clock, timer, and stopwatch for the terminal.");
 
-  pg.usage("[--config-dir <dir>] [--config|-u <file>] [<file>] [--colour <on|off|auto>]");
+  pg.usage("[--config-dir <dir>] [--config|-u <file>] [<file>] [--seed <n>] [--colour <on|off|auto>]");
   pg.usage("[--help|-h] [--colour <on|off|auto>]");
   pg.usage("[--version|-v] [--colour <on|off|auto>]");
   pg.usage("[--license] [--colour <on|off|auto>]");
+  pg.usage("[--bench-startup <n>] [--config-dir <dir>] [--config|-u <file>]");
 
   pg.info({"Key Bindings", {
     {"q, Q, <ctrl-c>", "quit the program"},
@@ -93,6 +94,9 @@ inline void program_init(Parg& pg)
     {"mkconfig! <file>", {
       {"", "overwrite or create 'file' and write the current config settings to it"},
     }},
+    {"stats", {
+      {"", "show the number of frames drawn and the bytes written per frame"},
+    }},
     {"mode <value>", {
       {"clock",
         "the view will display the current time"},
@@ -113,6 +117,14 @@ inline void program_init(Parg& pg)
       {"icon",
         "display the icon with the date"},
     }},
+    {"precision <value>", {
+      {"second",
+        "the stopwatch will display whole seconds"},
+      {"centisecond",
+        "the stopwatch will display hundredths of a second in the ascii and digital views"},
+      {"millisecond",
+        "the stopwatch will display thousandths of a second in the ascii and digital views"},
+    }},
     {"stopwatch <value>", {
       {"clear",
         "clear the stopwatch"},
@@ -134,10 +146,13 @@ inline void program_init(Parg& pg)
         "set the initial start time"},
     }},
     {"rate-input <milliseconds>", {
-      {"", "set the duration in milliseconds between reading user input"},
+      {"", "deprecated, has no effect, user input is read as soon as it arrives"},
     }},
     {"rate-refresh <milliseconds>", {
-      {"", "set the duration in milliseconds between redrawing the output"},
+      {"", "set the duration in milliseconds between redrawing animated colours, the clock is otherwise redrawn exactly when the displayed time changes"},
+    }},
+    {"rate-fraction <milliseconds>", {
+      {"", "set the duration in milliseconds between redrawing a running stopwatch that displays fractions of a second"},
     }},
     {"rate-status <milliseconds>", {
       {"", "set the duration in milliseconds to display status messages"},
@@ -146,7 +161,10 @@ inline void program_init(Parg& pg)
       {"", "set the locale, for example 'en_CA.utf8', an empty string clears the value"},
     }},
     {"timezone <str>", {
-      {"", "set the timezone, for example 'America/Vancouver', an empty string clears the value"},
+      {"", "set the timezone, for example 'America/Vancouver' or a POSIX TZ string such as 'EST5EDT,M3.2.0,M11.1.0', an empty string clears the value"},
+    }},
+    {"zones <str>", {
+      {"", "set a space separated list of timezones to show side by side in clock mode, each labelled with its name, for example 'UTC Europe/London Asia/Tokyo', an empty string clears the value"},
     }},
     {"date <str>", {
       {"", "set the date format string, an empty string clears the value"},
@@ -242,6 +260,10 @@ inline void program_init(Parg& pg)
         "auto size the clock to fill the screen, overrides the current x y block size"},
       {"auto-ratio",
         "auto size the clock to use the aspect ratio set by the command 'ratio', overrides the current x y block size and auto-size"},
+      {"damage",
+        "only redraw the parts of the screen that changed since the previous frame"},
+      {"sync",
+        "wrap each frame in a synchronized update so that it is displayed at once, only used when the terminal reports support"},
     }},
     {"style <value> <#000-#fff|#000000-#ffffff|0-255|Colour|reverse|clear>", {
       {"active-fg",
@@ -340,6 +362,8 @@ inline void program_init(Parg& pg)
   // options
   pg.set("config,u", "", "file", "Use the commands in the config file 'file' for initialization. All other initializations are skipped. To skip all initializations, use the special name 'NONE'.");
   pg.set("config-dir", "", "dir", "use 'dir' as the config directory. To skip all initializations, use the special name 'NONE'.");
+  pg.set("bench-startup", "0", "n", "Initialize the program 'n' times without starting it, then print the time taken by each startup phase as percentiles and the size of the first frame in bytes.");
+  pg.set("seed", "0", "n", "Seed the random colours with 'n' so that they repeat between runs, 0 picks a new seed on each run.");
   pg.set("colour", "auto", "on|off|auto", "Print the program info output with colour either on, off, or auto based on if stdout is a tty.");
 
   pg.set_pos();
@@ -4,6 +4,7 @@
 using Parg = OB::Parg;
 
 #include "ob/term.hh"
+#include "ob/random.hh"
 namespace iom = OB::Term::iomanip;
 namespace aec = OB::Term::ANSI_Escape_Codes;
 
@@ -12,14 +13,162 @@ namespace aec = OB::Term::ANSI_Escape_Codes;
 #include <fcntl.h>
 #include <unistd.h>
 
+#include <cmath>
 #include <cstddef>
+#include <cstdint>
 
+#include <array>
 #include <string>
+#include <vector>
+#include <chrono>
+#include <iomanip>
 #include <iostream>
+#include <algorithm>
 
 #include <filesystem>
 namespace fs = std::filesystem;
 
+// determine config directory
+// default to '~/.peaclock'
+static fs::path config_dir(Parg& pg)
+{
+  return pg.find("config-dir") ?
+    pg.get<fs::path>("config-dir") :
+    fs::path(OB::Term::env_var("HOME") + "/." + pg.name());
+}
+
+// repeat the program initialization 'n' times,
+// printing the timings of each startup phase
+static int bench_startup(int argc, char *argv[], std::size_t const n)
+{
+  using clock = std::chrono::steady_clock;
+
+  std::array<char const*, 7> const phases {"args", "init", "history", "config", "render", "flush", "total"};
+  std::array<std::vector<double>, 7> times;
+
+  for (auto& e : times)
+  {
+    e.reserve(n);
+  }
+
+  // render at the size of the terminal when there is one
+  std::size_t width {80};
+  std::size_t height {24};
+
+  if (std::size_t w {0}, h {0}; OB::Term::is_term(STDOUT_FILENO) &&
+    OB::Term::size(w, h) == 0 && w && h)
+  {
+    width = w;
+    height = h;
+  }
+
+  // the first frame is written to a sink to time its encoding
+  int const sink {open("/dev/null", O_WRONLY)};
+
+  if (sink == -1)
+  {
+    throw std::runtime_error("failed to open '/dev/null'");
+  }
+
+  std::size_t bytes {0};
+
+  for (std::size_t i = 0; i < n; ++i)
+  {
+    auto const begin = clock::now();
+    auto start = begin;
+
+    // store the microseconds since the previous phase
+    auto const lap = [&](std::size_t const phase) {
+      auto const now = clock::now();
+      times.at(phase).emplace_back(std::chrono::duration<double, std::micro>(now - start).count());
+      start = now;
+    };
+
+    Parg pg {argc, argv};
+    program_info(pg);
+    lap(0);
+
+    Tui tui {pg};
+    lap(1);
+
+    fs::path const dir {config_dir(pg)};
+    bool const has_dir {dir != "NONE" && fs::exists(dir) && fs::is_directory(dir)};
+
+    if (has_dir)
+    {
+      tui.base_config(dir);
+
+      // read only, a missing history directory is not created
+      tui.load_hist_command(dir / fs::path("history") / fs::path("command"), false);
+    }
+
+    lap(2);
+
+    // stop at the first config error instead of prompting on every run
+    if (has_dir && ! tui.load_config(pg.find("config") ? pg.get<fs::path>("config") :
+      dir / fs::path("config"), false))
+    {
+      close(sink);
+
+      return 1;
+    }
+
+    lap(3);
+
+    tui.render(width, height);
+    lap(4);
+
+    tui.flush(sink);
+    lap(5);
+
+    bytes = tui.stats().last;
+
+    times.at(6).emplace_back(std::chrono::duration<double, std::micro>(clock::now() - begin).count());
+  }
+
+  // nearest rank percentile of sorted values
+  auto const percentile = [](std::vector<double> const& vec, double const p) {
+    auto const rank = static_cast<std::size_t>(std::ceil(p / 100.0 * static_cast<double>(vec.size())));
+    return vec.at(rank > 0 ? rank - 1 : 0);
+  };
+
+  std::cout
+  << "startup " << n << " runs, microseconds\n"
+  << std::left << std::setw(9) << "phase"
+  << std::right
+  << std::setw(11) << "min"
+  << std::setw(11) << "p50"
+  << std::setw(11) << "p90"
+  << std::setw(11) << "p99"
+  << std::setw(11) << "max"
+  << "\n"
+  << std::fixed << std::setprecision(1);
+
+  for (std::size_t i = 0; i < phases.size(); ++i)
+  {
+    auto& vec = times.at(i);
+    std::sort(vec.begin(), vec.end());
+
+    std::cout
+    << std::left << std::setw(9) << phases.at(i)
+    << std::right
+    << std::setw(11) << vec.front()
+    << std::setw(11) << percentile(vec, 50)
+    << std::setw(11) << percentile(vec, 90)
+    << std::setw(11) << percentile(vec, 99)
+    << std::setw(11) << vec.back()
+    << "\n";
+  }
+
+  std::cout
+  << "first frame " << bytes << " bytes\n"
+  << std::flush;
+
+  close(sink);
+
+  return 0;
+}
+
 int main(int argc, char *argv[])
 {
   std::ios_base::sync_with_stdio(false);
@@ -31,6 +180,17 @@ int main(int argc, char *argv[])
 
   try
   {
+    // a fixed seed makes the random colours repeat between runs
+    if (auto const seed = pg.get<std::uint64_t>("seed"); seed > 0)
+    {
+      OB::Random::seed(seed);
+    }
+
+    if (auto const n = pg.get<std::size_t>("bench-startup"); n > 0)
+    {
+      return bench_startup(argc, argv, n);
+    }
+
     // init
     Tui tui {pg};
 
@@ -49,11 +209,7 @@ int main(int argc, char *argv[])
 
     // load files
     {
-      // determine config directory
-      // default to '~/.peaclock'
-      fs::path config_dir {pg.find("config-dir") ?
-        pg.get<fs::path>("config-dir") :
-        fs::path(OB::Term::env_var("HOME") + "/." + pg.name())};
+      fs::path config_dir {::config_dir(pg)};
 
       if (config_dir != "NONE" &&
         fs::exists(config_dir) && fs::is_directory(config_dir))
@@ -2,16 +2,21 @@
 #define OB_COLOR_HH
 
 #include "ob/string.hh"
+#include "ob/random.hh"
 #include "ob/term.hh"
 namespace aec = OB::Term::ANSI_Escape_Codes;
 
 #include <cmath>
 #include <cstdio>
 #include <cstddef>
+#include <cstdint>
 
+#include <map>
 #include <regex>
 #include <string>
-#include <random>
+#include <tuple>
+#include <memory>
+#include <vector>
 #include <sstream>
 #include <iostream>
 #include <algorithm>
@@ -169,6 +174,11 @@ public:
     {
       _fg = true;
       key(_key);
+
+      if (_mode != Mode::null)
+      {
+        palette();
+      }
     }
 
     return *this;
@@ -180,6 +190,11 @@ public:
     {
       _fg = false;
       key(_key);
+
+      if (_mode != Mode::null)
+      {
+        palette();
+      }
     }
 
     return *this;
@@ -206,27 +221,21 @@ public:
     {
       case Mode::rainbow:
       {
-        _hsl.h = _hsl.h < 100 ? _hsl.h + 0.2 : 0;
-        _value = _fg ? aec::fg_true(hsl_to_hex(_hsl)) :
-          aec::bg_true(hsl_to_hex(_hsl));
+        _hue = _hue < hue_steps ? _hue + 1 : 0;
 
         break;
       }
 
       case Mode::candy:
       {
-        _hsl.h = _hsl.h < 100 ? _hsl.h + 0.4 : 0;
-        _value = _fg ? aec::fg_true(hsl_to_hex(_hsl)) :
-          aec::bg_true(hsl_to_hex(_hsl));
+        _hue = _hue < hue_steps ? _hue + 2 : 0;
 
         break;
       }
 
       case Mode::party:
       {
-        _hsl.h = random(0, 100);
-        _value = _fg ? aec::fg_true(hsl_to_hex(_hsl)) :
-          aec::bg_true(hsl_to_hex(_hsl));
+        _hue = random(0, 100) * hue_scale;
 
         break;
       }
@@ -234,10 +243,13 @@ public:
       case Mode::null:
       default:
       {
-        break;
+        return *this;
       }
     }
 
+    _hsl.h = static_cast<double>(_hue) / hue_scale;
+    _value = (*_palette)[_hue];
+
     return *this;
   }
 
@@ -261,6 +273,7 @@ public:
       _hsl.h = val;
     }
 
+    _hue = static_cast<std::size_t>(std::lround(_hsl.h * hue_scale));
     _key = hsl_to_hex(_hsl);
     _value = _fg ? aec::fg_true(_key) : aec::bg_true(_key);
 
@@ -290,6 +303,11 @@ public:
     _key = hsl_to_hex(_hsl);
     _value = _fg ? aec::fg_true(_key) : aec::bg_true(_key);
 
+    if (_mode != Mode::null)
+    {
+      palette();
+    }
+
     return *this;
   }
 
@@ -316,6 +334,11 @@ public:
     _key = hsl_to_hex(_hsl);
     _value = _fg ? aec::fg_true(_key) : aec::bg_true(_key);
 
+    if (_mode != Mode::null)
+    {
+      palette();
+    }
+
     return *this;
   }
 
@@ -375,9 +398,10 @@ public:
 
         _key = k;
         _hsl = HSL {50, 50, 50};
-        _hsl.h = random(0, 100);
-        _value = _fg ? aec::fg_true(hsl_to_hex(_hsl)) :
-          aec::bg_true(hsl_to_hex(_hsl));
+        _hue = random(0, 100) * hue_scale;
+        _hsl.h = static_cast<double>(_hue) / hue_scale;
+        palette();
+        _value = (*_palette)[_hue];
         _valid = true;
       }
       else
@@ -423,13 +447,53 @@ public:
     return _valid;
   }
 
-  std::string value() const
+  std::string const& value() const
   {
     return _value;
   }
 
 private:
 
+  // escape sequences of every hue step for a given saturation and lightness
+  using Palette = std::vector<std::string>;
+
+  // hue steps per unit of hue, the rainbow step is one, the candy step is two
+  static std::size_t constexpr hue_scale {5};
+
+  // number of steps in the full hue range
+  static std::size_t constexpr hue_steps {100 * hue_scale};
+
+  // look up or build the palette of the current colour, shared between colours
+  void palette()
+  {
+    static std::map<std::tuple<bool, double, double>, std::shared_ptr<Palette const>> cache;
+
+    auto& res = cache[{_fg, _hsl.s, _hsl.l}];
+
+    if (! res)
+    {
+      auto pal = std::make_shared<Palette>();
+      pal->reserve(hue_steps + 2);
+      HSL hsl {_hsl};
+
+      // one past the end, a candy step can land on it before wrapping
+      for (std::size_t i = 0; i < hue_steps + 2; ++i)
+      {
+        hsl.h = static_cast<double>(i) / hue_scale;
+        auto const rgb = hsl_to_rgb(hsl);
+        auto const r = static_cast<std::uint8_t>(rgb.r);
+        auto const g = static_cast<std::uint8_t>(rgb.g);
+        auto const b = static_cast<std::uint8_t>(rgb.b);
+        auto& str = pal->emplace_back();
+        _fg ? aec::fg_true(str, r, g, b) : aec::bg_true(str, r, g, b);
+      }
+
+      res = std::move(pal);
+    }
+
+    _palette = res;
+  }
+
   HSL hex_to_hsl(std::string const& hex) const
   {
     return rgb_to_hsl(hex_to_rgb(hex));
@@ -627,11 +691,7 @@ private:
 
   std::size_t random(std::size_t min, std::size_t max) const
   {
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_int_distribution<> distr(min, max);
-
-    return static_cast<std::size_t>(distr(gen));
+    return OB::Random::range(min, max);
   }
 
   bool _valid {false};
@@ -641,6 +701,10 @@ private:
 
   Mode::Type _mode {Mode::null};
   HSL _hsl {50, 50, 50};
+
+  // current hue step and precomputed escape sequences of an animated colour
+  std::size_t _hue {0};
+  std::shared_ptr<Palette const> _palette;
 }; // Color
 
 } // namespace OB
@@ -0,0 +1,247 @@
+#ifndef OB_DATEFMT_HH
+#define OB_DATEFMT_HH
+
+#include <ctime>
+#include <cstddef>
+
+#include <string>
+#include <string_view>
+#include <locale>
+#include <sstream>
+#include <iomanip>
+#include <vector>
+#include <algorithm>
+#include <initializer_list>
+
+namespace OB
+{
+
+// strftime style date formatter, the format is compiled into the list of
+// tm fields it reads and the output is only rebuilt when one of them changes
+class Datefmt
+{
+public:
+
+  using Field = int std::tm::*;
+
+  explicit Datefmt(std::string const& fmt = {})
+  {
+    this->fmt(fmt);
+  }
+
+  Datefmt(Datefmt&&) = default;
+  Datefmt(Datefmt const&) = delete;
+  ~Datefmt() = default;
+
+  Datefmt& operator=(Datefmt&&) = default;
+  Datefmt& operator=(Datefmt const&) = delete;
+
+  Datefmt& fmt(std::string const& str)
+  {
+    _fmt = str;
+    compile();
+
+    return reset();
+  }
+
+  std::string const& fmt() const
+  {
+    return _fmt;
+  }
+
+  // the locale is looked up once, on the next format
+  Datefmt& locale(std::string const& str)
+  {
+    _locale = str;
+    _imbued = false;
+
+    return reset();
+  }
+
+  // drop the cached output, for changes the tm fields do not show,
+  // such as a new timezone
+  Datefmt& reset()
+  {
+    _valid = false;
+
+    return *this;
+  }
+
+  // tm fields the format depends on
+  std::vector<Field> const& fields() const
+  {
+    return _fields;
+  }
+
+  bool has(Field const field) const
+  {
+    return std::find(_fields.begin(), _fields.end(), field) != _fields.end();
+  }
+
+  std::string const& str(std::tm const& tm)
+  {
+    if (_valid && std::equal(_fields.begin(), _fields.end(), _values.begin(),
+      [&](auto const field, auto const value) { return tm.*field == value; }))
+    {
+      return _str;
+    }
+
+    if (! _imbued)
+    {
+      _os.imbue(std::locale(_locale));
+      _imbued = true;
+    }
+
+    _os.str({});
+    _os.clear();
+    _os << std::put_time(&tm, _fmt.c_str());
+    _str = _os.str();
+
+    for (std::size_t i = 0; i < _fields.size(); ++i)
+    {
+      _values[i] = tm.*_fields[i];
+    }
+
+    _valid = true;
+
+    return _str;
+  }
+
+private:
+
+  void add(std::initializer_list<Field> const fields)
+  {
+    for (auto const field : fields)
+    {
+      if (! has(field))
+      {
+        _fields.emplace_back(field);
+      }
+    }
+  }
+
+  void compile()
+  {
+    _fields.clear();
+
+    auto const second = {&std::tm::tm_sec};
+    auto const minute = {&std::tm::tm_min};
+    auto const hour = {&std::tm::tm_hour};
+    auto const day = {&std::tm::tm_mday, &std::tm::tm_mon, &std::tm::tm_year};
+    auto const zone = {&std::tm::tm_isdst};
+
+    auto const modifier = [](char const c) {
+      return std::string_view("-_0^#EO").find(c) != std::string_view::npos ||
+        (c >= '1' && c <= '9');
+    };
+
+    for (std::size_t i = 0; i + 1 < _fmt.size(); ++i)
+    {
+      if (_fmt[i] != '%')
+      {
+        continue;
+      }
+
+      ++i;
+
+      // skip the flags, the field width, and the alternative
+      // representation modifiers, such as '%-d', '%_5H' or '%Ey'
+      while (i + 1 < _fmt.size() && modifier(_fmt[i]))
+      {
+        ++i;
+      }
+
+      switch (_fmt[i])
+      {
+        case '%': case 'n': case 't':
+        {
+          break;
+        }
+
+        case 'S':
+        {
+          add(second);
+
+          break;
+        }
+
+        case 'M':
+        {
+          add(minute);
+
+          break;
+        }
+
+        case 'H': case 'I': case 'k': case 'l': case 'p': case 'P':
+        {
+          add(hour);
+
+          break;
+        }
+
+        case 'R':
+        {
+          add(hour);
+          add(minute);
+
+          break;
+        }
+
+        case 'T': case 'r': case 'X':
+        {
+          add(hour);
+          add(minute);
+          add(second);
+
+          break;
+        }
+
+        case 'a': case 'A': case 'b': case 'B': case 'h': case 'd': case 'e':
+        case 'j': case 'm': case 'u': case 'w': case 'U': case 'W': case 'V':
+        case 'g': case 'G': case 'y': case 'Y': case 'C': case 'D': case 'F':
+        case 'x':
+        {
+          add(day);
+
+          break;
+        }
+
+        case 'z': case 'Z':
+        {
+          add(zone);
+
+          break;
+        }
+
+        // the date and time, the epoch, and anything unknown
+        default:
+        {
+          add(day);
+          add(hour);
+          add(minute);
+          add(second);
+          add(zone);
+
+          break;
+        }
+      }
+    }
+
+    _values.assign(_fields.size(), 0);
+  }
+
+  std::string _fmt;
+  std::vector<Field> _fields;
+  std::vector<int> _values;
+
+  std::string _locale;
+  std::ostringstream _os;
+  bool _imbued {false};
+
+  std::string _str;
+  bool _valid {false};
+}; // class Datefmt
+
+} // namespace OB
+
+#endif // OB_DATEFMT_HH
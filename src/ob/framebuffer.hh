@@ -0,0 +1,699 @@
+#ifndef OB_FRAMEBUFFER_HH
+#define OB_FRAMEBUFFER_HH
+
+#include "ob/color.hh"
+#include "ob/text.hh"
+#include "ob/term.hh"
+namespace aec = OB::Term::ANSI_Escape_Codes;
+
+#include <cstddef>
+#include <cstdint>
+
+#include <string>
+#include <string_view>
+#include <charconv>
+#include <algorithm>
+#include <vector>
+#include <memory>
+#include <utility>
+#include <unordered_map>
+
+namespace OB
+{
+
+// off-screen grid of cells that the program rasterizes each frame into,
+// encoded into escape sequences in a single pass, either in full or as the
+// difference from the previous frame
+class Framebuffer
+{
+public:
+
+  struct Cell
+  {
+    // ascii code point, interned glyph id, or 0 for the right half of a wide glyph
+    std::uint32_t glyph {' '};
+
+    // interned foreground and background style ids
+    std::uint32_t fg {0};
+    std::uint32_t bg {0};
+
+    bool operator==(Cell const& rhs) const
+    {
+      return glyph == rhs.glyph && fg == rhs.fg && bg == rhs.bg;
+    }
+
+    bool operator!=(Cell const& rhs) const
+    {
+      return ! (*this == rhs);
+    }
+  }; // struct Cell
+
+  Framebuffer() = default;
+  Framebuffer(Framebuffer&&) = default;
+  Framebuffer(Framebuffer const&) = default;
+  ~Framebuffer() = default;
+
+  Framebuffer& operator=(Framebuffer&&) = default;
+  Framebuffer& operator=(Framebuffer const&) = default;
+
+  std::size_t width() const
+  {
+    return _width;
+  }
+
+  std::size_t height() const
+  {
+    return _height;
+  }
+
+  Framebuffer& size(std::size_t const width, std::size_t const height)
+  {
+    if (width == _width && height == _height)
+    {
+      return *this;
+    }
+
+    _width = width;
+    _height = height;
+    _cells.assign(_width * _height, Cell());
+
+    return *this;
+  }
+
+  // forget the contents, the next diff against this buffer repaints everything
+  Framebuffer& invalidate()
+  {
+    _width = 0;
+    _height = 0;
+    _cells.clear();
+
+    return *this;
+  }
+
+  // fill every cell with a blank glyph using the given background
+  Framebuffer& clear(OB::Color const& bg)
+  {
+    if (_table->glyph.size() > table_max || _table->style.size() > table_max)
+    {
+      rebuild();
+    }
+
+    std::fill(_cells.begin(), _cells.end(), Cell {' ', 0, style(bg)});
+
+    return *this;
+  }
+
+  // restrict drawing to a rectangle, the coordinates given to put are then
+  // relative to its top left corner and cells outside of it are left alone
+  Framebuffer& viewport(std::size_t const x, std::size_t const y,
+    std::size_t const width, std::size_t const height)
+  {
+    _vx = x;
+    _vy = y;
+    _vw = width;
+    _vh = height;
+
+    return *this;
+  }
+
+  // draw to the whole buffer again
+  Framebuffer& viewport()
+  {
+    return viewport(0, 0, npos, npos);
+  }
+
+  Cell& at(std::size_t const x, std::size_t const y)
+  {
+    return _cells[x + (y * _width)];
+  }
+
+  Cell const& at(std::size_t const x, std::size_t const y) const
+  {
+    return _cells[x + (y * _width)];
+  }
+
+  // intern a style, the escape sequence value of a colour
+  std::uint32_t style(std::string const& str)
+  {
+    if (str.empty())
+    {
+      return 0;
+    }
+
+    if (auto const it = _table->style_id.find(str); it != _table->style_id.end())
+    {
+      return it->second;
+    }
+
+    auto const id = static_cast<std::uint32_t>(_table->style.size());
+    _table->style.emplace_back(str);
+    _table->style_id.emplace(str, id);
+    _table->sgr.emplace_back(parse_sgr(str));
+
+    return id;
+  }
+
+  std::uint32_t style(OB::Color const& color)
+  {
+    return style(color.value());
+  }
+
+  // intern a single grapheme
+  std::uint32_t glyph(std::string_view str)
+  {
+    if (str.size() == 1 && static_cast<unsigned char>(str[0]) < 0x80)
+    {
+      return static_cast<std::uint32_t>(str[0]);
+    }
+
+    // look up through a reused key to avoid allocating on every call
+    _key.assign(str);
+
+    if (auto const it = _table->glyph_id.find(_key); it != _table->glyph_id.end())
+    {
+      return it->second;
+    }
+
+    auto const id = static_cast<std::uint32_t>(_table->glyph.size() + 0x80);
+    _table->glyph.emplace_back(_key);
+    _table->glyph_id.emplace(_key, id);
+
+    return id;
+  }
+
+  // set the cell at x y, a glyph of 2 columns also covers the following cell
+  Framebuffer& put(std::size_t x, std::size_t y, std::uint32_t const glyph,
+    std::size_t const cols, std::uint32_t const fg, std::uint32_t const bg)
+  {
+    if (x + cols > _vw || y >= _vh)
+    {
+      return *this;
+    }
+
+    x += _vx;
+    y += _vy;
+
+    if (x + cols > _width || y >= _height)
+    {
+      return *this;
+    }
+
+    auto* cell = &_cells[x + (y * _width)];
+
+    // overwriting half of a wide glyph blanks the other half
+    if (cell->glyph == 0 && x > 0)
+    {
+      (cell - 1)->glyph = ' ';
+    }
+
+    if (x + cols < _width && (cell + cols)->glyph == 0)
+    {
+      (cell + cols)->glyph = ' ';
+    }
+
+    *cell = Cell {glyph, fg, bg};
+
+    if (cols == 2)
+    {
+      *(cell + 1) = Cell {0, fg, bg};
+    }
+
+    return *this;
+  }
+
+  // write a line of text starting at x y, returns the number of columns used
+  std::size_t text(std::size_t x, std::size_t const y, std::string_view str,
+    std::uint32_t const fg, std::uint32_t const bg)
+  {
+    std::size_t const begin {x};
+
+    for (std::size_t i = 0; i < str.size() && x < _width;)
+    {
+      auto const ch = static_cast<unsigned char>(str[i]);
+
+      if (ch < 0x80)
+      {
+        put(x, y, ch, 1, fg, bg);
+        ++x;
+        ++i;
+
+        continue;
+      }
+
+      // non-ascii run, segment into graphemes
+      std::size_t end {i};
+
+      while (end < str.size() && static_cast<unsigned char>(str[end]) >= 0x80)
+      {
+        ++end;
+      }
+
+      _view.str(str.substr(i, end - i));
+
+      for (auto const& e : _view)
+      {
+        if (x + e.cols > _width)
+        {
+          break;
+        }
+
+        put(x, y, glyph(e.str), e.cols, fg, bg);
+        x += e.cols;
+      }
+
+      i = end;
+    }
+
+    return x - begin;
+  }
+
+  // append the escape sequences that draw the whole buffer
+  std::string& encode(std::string& out) const
+  {
+    return encode(nullptr, out);
+  }
+
+  // append the escape sequences that turn the 'prev' buffer into this buffer
+  std::string& diff(Framebuffer const& prev, std::string& out) const
+  {
+    return encode(&prev, out);
+  }
+
+private:
+
+  static std::size_t constexpr npos {static_cast<std::size_t>(-1)};
+  static std::uint32_t constexpr npos32 {static_cast<std::uint32_t>(-1)};
+
+  // upper bound on interned values before the table is rebuilt
+  static std::size_t constexpr table_max {1 << 16};
+
+  // sgr attributes are kept as bit n - 1 for parameter n, 1 bold to 9 strike
+  // parameter that turns attribute n off, 22 covers bold and dim,
+  // 25 both blinks
+  static constexpr int attr_off(int const n)
+  {
+    return n == 1 ? 22 : n == 6 ? 25 : 20 + n;
+  }
+
+  // effect of a style on the terminal, parsed from its sgr sequences
+  struct Sgr
+  {
+    // false when the style holds anything other than known sgr parameters
+    bool valid {true};
+
+    // the style starts with a reset
+    bool reset {false};
+
+    // attributes turned on and off
+    std::uint16_t set {0};
+    std::uint16_t unset {0};
+
+    // colour parameters, such as '31' or '38;5;208', empty for the default
+    bool has_fg {false};
+    bool has_bg {false};
+    std::string fg;
+    std::string bg;
+  }; // struct Sgr
+
+  // attributes and colours set on the terminal
+  struct State
+  {
+    std::uint16_t attr {0};
+    std::string_view fg;
+    std::string_view bg;
+
+    State& apply(Sgr const& sgr)
+    {
+      if (sgr.reset)
+      {
+        *this = State();
+      }
+
+      attr = static_cast<std::uint16_t>((attr & ~sgr.unset) | sgr.set);
+
+      if (sgr.has_fg)
+      {
+        fg = sgr.fg;
+      }
+
+      if (sgr.has_bg)
+      {
+        bg = sgr.bg;
+      }
+
+      return *this;
+    }
+
+    bool operator==(State const& rhs) const
+    {
+      return attr == rhs.attr && fg == rhs.fg && bg == rhs.bg;
+    }
+
+    bool operator!=(State const& rhs) const
+    {
+      return ! (*this == rhs);
+    }
+  }; // struct State
+
+  struct Table
+  {
+    Table()
+    {
+      style.emplace_back("");
+      sgr.emplace_back();
+    }
+
+    std::vector<std::string> glyph;
+    std::unordered_map<std::string, std::uint32_t> glyph_id;
+
+    std::vector<std::string> style;
+    std::unordered_map<std::string, std::uint32_t> style_id;
+    std::vector<Sgr> sgr;
+  }; // struct Table
+
+  // parse the sgr sequences of a style
+  static Sgr parse_sgr(std::string_view str)
+  {
+    Sgr sgr;
+    std::vector<int> param;
+
+    while (! str.empty())
+    {
+      auto const end = str.find('m');
+
+      if (str.size() < 3 || str.substr(0, 2) != "\x1b[" || end == std::string_view::npos)
+      {
+        sgr.valid = false;
+
+        return sgr;
+      }
+
+      // parameters between the csi and the final byte, an empty one is 0
+      param.clear();
+
+      for (auto params = str.substr(2, end - 2);;)
+      {
+        auto const sep = params.find(';');
+        auto const num = params.substr(0, sep);
+        int val {0};
+
+        if (! num.empty() &&
+          std::from_chars(num.data(), num.data() + num.size(), val).ptr != num.data() + num.size())
+        {
+          sgr.valid = false;
+
+          return sgr;
+        }
+
+        param.emplace_back(val);
+
+        if (sep == std::string_view::npos)
+        {
+          break;
+        }
+
+        params.remove_prefix(sep + 1);
+      }
+
+      str.remove_prefix(end + 1);
+
+      for (std::size_t i = 0; i < param.size(); ++i)
+      {
+        auto const p = param[i];
+
+        // 8 and 24 bit colours take 2 or 4 more parameters
+        if (p == 38 || p == 48)
+        {
+          std::size_t const n {i + 1 < param.size() && param[i + 1] == 5 ? 2u :
+            i + 1 < param.size() && param[i + 1] == 2 ? 4u : 0u};
+
+          if (n == 0 || i + n >= param.size())
+          {
+            sgr.valid = false;
+
+            return sgr;
+          }
+
+          auto& colour = p == 38 ? sgr.fg : sgr.bg;
+          colour = std::to_string(p);
+
+          for (std::size_t j = 1; j <= n; ++j)
+          {
+            colour += ';';
+            colour += std::to_string(param[i + j]);
+          }
+
+          (p == 38 ? sgr.has_fg : sgr.has_bg) = true;
+          i += n;
+        }
+        else if (p == 0)
+        {
+          sgr = Sgr();
+          sgr.reset = true;
+        }
+        else if (p >= 1 && p <= 9)
+        {
+          auto const bit = static_cast<std::uint16_t>(1u << (p - 1));
+          sgr.set = static_cast<std::uint16_t>(sgr.set | bit);
+          sgr.unset = static_cast<std::uint16_t>(sgr.unset & ~bit);
+        }
+        else if (p == 22 || (p >= 23 && p <= 25) || (p >= 27 && p <= 29))
+        {
+          // every attribute the parameter turns off
+          std::uint16_t bits {0};
+
+          for (int n = 1; n <= 9; ++n)
+          {
+            if (attr_off(n) == p)
+            {
+              bits = static_cast<std::uint16_t>(bits | (1u << (n - 1)));
+            }
+          }
+
+          sgr.set = static_cast<std::uint16_t>(sgr.set & ~bits);
+          sgr.unset = static_cast<std::uint16_t>(sgr.unset | bits);
+        }
+        else if ((p >= 30 && p <= 37) || (p >= 90 && p <= 97) || p == 39)
+        {
+          sgr.fg = p == 39 ? std::string() : std::to_string(p);
+          sgr.has_fg = true;
+        }
+        else if ((p >= 40 && p <= 47) || (p >= 100 && p <= 107) || p == 49)
+        {
+          sgr.bg = p == 49 ? std::string() : std::to_string(p);
+          sgr.has_bg = true;
+        }
+        else
+        {
+          sgr.valid = false;
+
+          return sgr;
+        }
+      }
+    }
+
+    return sgr;
+  }
+
+  // append the sgr sequence that changes the terminal from one state to another
+  static void transition(State const& from, State const& to, std::string& out)
+  {
+    auto const begin = out.size();
+
+    // separator before each parameter, the csi before the first
+    auto const sep = [&]() -> std::string& {
+      return out += out.size() == begin ? "\x1b[" : ";";
+    };
+
+    std::uint16_t on {static_cast<std::uint16_t>(to.attr & ~from.attr)};
+    std::uint16_t off {static_cast<std::uint16_t>(from.attr & ~to.attr)};
+
+    for (int n = 1; n <= 9; ++n)
+    {
+      if (! (off & (1u << (n - 1))))
+      {
+        continue;
+      }
+
+      // one parameter can turn off several attributes, those still wanted are set again
+      for (int m = 1; m <= 9; ++m)
+      {
+        if (attr_off(m) == attr_off(n))
+        {
+          off = static_cast<std::uint16_t>(off & ~(1u << (m - 1)));
+          on = static_cast<std::uint16_t>(on | (to.attr & (1u << (m - 1))));
+        }
+      }
+
+      aec::append_num(sep(), static_cast<std::size_t>(attr_off(n)));
+    }
+
+    for (int n = 1; n <= 9; ++n)
+    {
+      if (on & (1u << (n - 1)))
+      {
+        aec::append_num(sep(), static_cast<std::size_t>(n));
+      }
+    }
+
+    if (from.fg != to.fg)
+    {
+      sep() += to.fg.empty() ? "39" : to.fg;
+    }
+
+    if (from.bg != to.bg)
+    {
+      sep() += to.bg.empty() ? "49" : to.bg;
+    }
+
+    if (out.size() != begin)
+    {
+      out += 'm';
+    }
+  }
+
+  std::string& encode(Framebuffer const* prev, std::string& out) const
+  {
+    bool const full {! prev || prev->_width != _width || prev->_height != _height ||
+      prev->_table != _table};
+
+    std::size_t cx {npos};
+    std::size_t cy {npos};
+    std::uint32_t fg {npos32};
+    std::uint32_t bg {npos32};
+
+    // a diff follows a frame that ended in the default state,
+    // a full frame may follow anything and starts with a reset
+    State state;
+    bool known {! full};
+
+    for (std::size_t y = 0; y < _height; ++y)
+    {
+      for (std::size_t x = 0; x < _width; ++x)
+      {
+        auto const& cell = at(x, y);
+
+        // right half of a wide glyph, drawn with its left half
+        if (cell.glyph == 0)
+        {
+          continue;
+        }
+
+        bool const wide {x + 1 < _width && at(x + 1, y).glyph == 0};
+
+        if (! full && cell == prev->at(x, y) && (! wide || at(x + 1, y) == prev->at(x + 1, y)))
+        {
+          continue;
+        }
+
+        // move the cursor only when it is not already in place
+        if (cy != y || cx != x)
+        {
+          if (cy == y && cx < x)
+          {
+            aec::cursor_right(out, x - cx);
+          }
+          else
+          {
+            aec::cursor_set(out, x + 1, y + 1);
+          }
+        }
+
+        // change the style only when it differs from the previous cell
+        if (fg != cell.fg || bg != cell.bg)
+        {
+          auto const& sgr_fg = _table->sgr[cell.fg];
+          auto const& sgr_bg = _table->sgr[cell.bg];
+
+          if (sgr_fg.valid && sgr_bg.valid)
+          {
+            // only the attributes and colours that change
+            auto const next = State().apply(sgr_fg).apply(sgr_bg);
+
+            if (! known)
+            {
+              out += aec::clear;
+              state = State();
+              known = true;
+            }
+
+            transition(state, next, out);
+            state = next;
+          }
+          else
+          {
+            // a style that is not understood is written as is after a reset
+            out += aec::clear;
+            out += _table->style[cell.fg];
+            out += _table->style[cell.bg];
+            known = false;
+          }
+
+          fg = cell.fg;
+          bg = cell.bg;
+        }
+
+        if (cell.glyph < 0x80)
+        {
+          out += static_cast<char>(cell.glyph);
+        }
+        else
+        {
+          out += _table->glyph[cell.glyph - 0x80];
+        }
+
+        cx = x + (wide ? 2 : 1);
+        cy = y;
+      }
+    }
+
+    // leave the terminal in the default state
+    if (! known || state != State())
+    {
+      out += aec::clear;
+    }
+
+    return out;
+  }
+
+  // move the cells over to a fresh table, dropping unused values
+  void rebuild()
+  {
+    auto const table = _table;
+    _table = std::make_shared<Table>();
+
+    for (auto& e : _cells)
+    {
+      if (e.glyph >= 0x80)
+      {
+        e.glyph = glyph(table->glyph[e.glyph - 0x80]);
+      }
+
+      e.fg = style(table->style[e.fg]);
+      e.bg = style(table->style[e.bg]);
+    }
+  }
+
+  std::size_t _width {0};
+  std::size_t _height {0};
+  std::vector<Cell> _cells;
+
+  // drawing area, the whole buffer by default
+  std::size_t _vx {0};
+  std::size_t _vy {0};
+  std::size_t _vw {npos};
+  std::size_t _vh {npos};
+
+  // interned glyphs and styles, shared between copies of a buffer
+  std::shared_ptr<Table> _table {std::make_shared<Table>()};
+
+  // grapheme segmentation of non-ascii text
+  OB::Text::View _view;
+
+  // scratch key for glyph lookups
+  std::string _key;
+}; // class Framebuffer
+
+} // namespace OB
+
+#endif // OB_FRAMEBUFFER_HH
@@ -0,0 +1,103 @@
+#ifndef OB_RANDOM_HH
+#define OB_RANDOM_HH
+
+#include <cstddef>
+#include <cstdint>
+
+#include <limits>
+#include <random>
+
+namespace OB::Random
+{
+
+// xoshiro256** generator, satisfies UniformRandomBitGenerator
+class Xoshiro
+{
+public:
+
+  using result_type = std::uint64_t;
+
+  explicit Xoshiro(result_type const seed) noexcept
+  {
+    this->seed(seed);
+  }
+
+  Xoshiro(Xoshiro&&) = default;
+  Xoshiro(Xoshiro const&) = default;
+  ~Xoshiro() = default;
+
+  Xoshiro& operator=(Xoshiro&&) = default;
+  Xoshiro& operator=(Xoshiro const&) = default;
+
+  static constexpr result_type min()
+  {
+    return std::numeric_limits<result_type>::min();
+  }
+
+  static constexpr result_type max()
+  {
+    return std::numeric_limits<result_type>::max();
+  }
+
+  // expand the seed into the state with splitmix64
+  void seed(result_type seed) noexcept
+  {
+    for (auto& e : _state)
+    {
+      seed += 0x9e3779b97f4a7c15;
+      auto z = seed;
+      z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+      z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+      e = z ^ (z >> 31);
+    }
+  }
+
+  result_type operator()() noexcept
+  {
+    auto const res = rotl(_state[1] * 5, 7) * 9;
+    auto const t = _state[1] << 17;
+
+    _state[2] ^= _state[0];
+    _state[3] ^= _state[1];
+    _state[1] ^= _state[2];
+    _state[0] ^= _state[3];
+    _state[2] ^= t;
+    _state[3] = rotl(_state[3], 45);
+
+    return res;
+  }
+
+private:
+
+  static constexpr result_type rotl(result_type const x, int const k)
+  {
+    return (x << k) | (x >> (64 - k));
+  }
+
+  result_type _state[4] {};
+}; // class Xoshiro
+
+// generator shared by the calling thread, seeded once from the system
+inline Xoshiro& engine()
+{
+  thread_local Xoshiro engine {(static_cast<Xoshiro::result_type>(std::random_device{}()) << 32) ^
+    std::random_device{}()};
+
+  return engine;
+}
+
+// reseed the shared generator, the same seed gives the same sequence
+inline void seed(Xoshiro::result_type const seed)
+{
+  engine().seed(seed);
+}
+
+// uniform integer in the closed range min to max
+inline std::size_t range(std::size_t const min, std::size_t const max)
+{
+  return std::uniform_int_distribution<std::size_t>(min, max)(engine());
+}
+
+} // namespace OB::Random
+
+#endif // OB_RANDOM_HH
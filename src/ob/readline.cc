@@ -721,7 +721,7 @@ void Readline::hist_push(std::string const& str)
   }
 }
 
-void Readline::hist_load(fs::path const& path)
+void Readline::hist_load(fs::path const& path, bool const save)
 {
   if (! path.empty())
   {
@@ -737,7 +737,10 @@ void Readline::hist_load(fs::path const& path)
       }
     }
 
-    hist_open(path);
+    if (save)
+    {
+      hist_open(path);
+    }
   }
 }
 
@@ -28,7 +28,8 @@ public:
   std::string operator()(bool& is_running);
 
   void hist_push(std::string const& str);
-  void hist_load(fs::path const& path);
+  // read the history file, new entries are appended to it unless save is false
+  void hist_load(fs::path const& path, bool const save = true);
 
 private:
 
@@ -3,6 +3,7 @@
 
 #include "ob/color.hh"
 #include "ob/text.hh"
+#include "ob/framebuffer.hh"
 #include "ob/term.hh"
 namespace aec = OB::Term::ANSI_Escape_Codes;
 
@@ -45,6 +46,13 @@ public:
     return os;
   }
 
+  friend OB::Framebuffer& operator<<(OB::Framebuffer& fb, Rect& obj)
+  {
+    obj.draw(fb);
+
+    return fb;
+  }
+
   Rect& draw(std::ostream& os)
   {
     bool _border {false};
@@ -486,6 +494,270 @@ public:
     return *this;
   }
 
+  // rasterize into the cells of a framebuffer,
+  // cells that would be skipped over when drawing to a stream are left untouched
+  Rect& draw(OB::Framebuffer& fb)
+  {
+    bool const border {_border_top || _border_bottom || _border_left || _border_right};
+    bool const padding {_padding_top || _padding_bottom || _padding_left || _padding_right};
+
+    auto padding_top = _padding_top;
+    auto padding_bottom = _padding_bottom;
+    auto padding_left = _padding_left;
+    auto padding_right = _padding_right;
+
+    if (border && padding)
+    {
+      padding_top += _border_top;
+      padding_bottom += _border_bottom;
+      padding_left += _border_left;
+      padding_right += _border_right;
+    }
+
+    std::size_t text_width {_w - _border_left - _border_right - _padding_left - _padding_right};
+    std::size_t text_height {_h - _border_top - _border_bottom - _padding_top - _padding_bottom};
+
+    // split the text into lines, reusing the buffers of the previous draw
+    std::size_t row {0};
+    auto& ln = _lines;
+    auto& lnv = _lnv;
+    ln.clear();
+
+    for (std::string_view str {_text.str()};;)
+    {
+      auto const end = str.find('\n');
+      ln.emplace_back(str.substr(0, end));
+
+      if (end == std::string_view::npos)
+      {
+        break;
+      }
+
+      str.remove_prefix(end + 1);
+    }
+
+    auto const fg_border = fb.style(_border_fg);
+    auto const bg_border = fb.style(_border_bg);
+    auto const bg = fb.style(_color_bg);
+    auto fg = fb.style(_color_fg);
+    bool style_main {true};
+
+    bool const transparent {_fill == " " && _color_bg.key() == "clear"};
+    auto const fill = fb.glyph(_fill);
+    std::size_t const fill_cols {_fill.empty() ? 1 : lnv.str(_fill).cols()};
+
+    std::size_t y_begin {0};
+
+    // determine y axis alignment
+    switch (_y_align)
+    {
+      case Align::center:
+      {
+        if (text_height / 2 >= ln.size() / 2)
+        {
+          y_begin = text_height / 2 - ln.size() / 2;
+        }
+
+        break;
+      }
+
+      case Align::bottom:
+      {
+        if (text_height >= ln.size())
+        {
+          y_begin = text_height - ln.size();
+        }
+
+        break;
+      }
+
+      case Align::top:
+      default:
+      {
+        break;
+      }
+    }
+
+    for (std::size_t y = 0; y < _h && y + _y <= _y_max; ++y)
+    {
+      // framebuffer coordinates are 0 based
+      std::size_t const fy {y + _y - 1};
+
+      for (std::size_t x = 0; x < _w && x + _x <= _x_max; ++x)
+      {
+        std::size_t const fx {x + _x - 1};
+
+        if (border)
+        {
+          std::string const* edge {nullptr};
+
+          if (y == 0 || x == 0)
+          {
+            if (y == 0 && x == 0 && (_border_top || _border_left))
+            {
+              edge = &_corner_top_left;
+            }
+            else if (y == 0 && x + 1 == _w && (_border_top || _border_right))
+            {
+              edge = &_corner_top_right;
+            }
+            else if (y + 1 == _h && x == 0 && (_border_bottom || _border_left))
+            {
+              edge = &_corner_bottom_left;
+            }
+            else if (y == 0 && _border_top)
+            {
+              edge = &_line_top;
+            }
+            else if (x == 0 && _border_left)
+            {
+              edge = &_line_left;
+            }
+          }
+          else if (y + 1 == _h && x + 1 == _w && (_border_bottom || _border_right))
+          {
+            edge = &_corner_bottom_right;
+          }
+          else if (y + 1 == _h && _border_bottom)
+          {
+            edge = &_line_bottom;
+          }
+          else if (x + 1 == _w && _border_right)
+          {
+            edge = &_line_right;
+          }
+
+          if (edge)
+          {
+            style_main = false;
+            fb.put(fx, fy, fb.glyph(*edge), 1, fg_border, bg_border);
+
+            continue;
+          }
+        }
+
+        if (! style_main)
+        {
+          fg = fb.style(_color_fg.step());
+          style_main = true;
+        }
+
+        if (padding && (y < padding_top || y + padding_bottom >= _h ||
+          x < padding_left || x + padding_right >= _w))
+        {
+          continue;
+        }
+
+        if (! _text.empty() && y >= y_begin && row < ln.size())
+        {
+          // set the view to the current line
+          lnv.str(ln.at(row++));
+
+          // line syntax highlighting
+          syntax(lnv);
+
+          // total columns in the current line
+          auto tcols = lnv.cols();
+
+          // total columns used so far
+          std::size_t cols {0};
+
+          // determine x axis alignment
+          switch (_x_align)
+          {
+            case Align::center:
+            {
+              if (text_width / 2 >= tcols / 2)
+              {
+                cols = text_width / 2 - tcols / 2;
+              }
+
+              break;
+            }
+
+            case Align::right:
+            {
+              if (text_width >= tcols)
+              {
+                cols = text_width - tcols;
+              }
+
+              break;
+            }
+
+            case Align::left:
+            default:
+            {
+              break;
+            }
+          }
+
+          lnv.str(lnv.colstr(0, tcols <= text_width ? text_width : text_width - 1));
+
+          std::size_t col {fx + cols};
+          std::size_t pos_line {0};
+          std::size_t pos_syntax {0};
+
+          for (auto const& e : lnv)
+          {
+            // TODO does not handle when syntax pos has multiple equal values
+            if (pos_syntax < _syntax.size() && _syntax.at(pos_syntax).first == pos_line)
+            {
+              // the highlight colour is layered on top of the main style
+              auto const& hl = _highlight.at(_syntax.at(pos_syntax).second).second;
+
+              if (hl.is_fg())
+              {
+                fb.put(col, fy, fb.glyph(e.str), e.cols, fb.style(_color_fg.value() + hl.value()), bg);
+              }
+              else
+              {
+                fb.put(col, fy, fb.glyph(e.str), e.cols, fg, fb.style(_color_bg.value() + hl.value()));
+              }
+
+              ++pos_syntax;
+            }
+            else
+            {
+              if (_color_fg.mode() == OB::Color::Mode::party)
+              {
+                fg = fb.style(_color_fg.step());
+              }
+
+              fb.put(col, fy, fb.glyph(e.str), e.cols, fg, bg);
+            }
+
+            col += e.cols;
+            ++pos_line;
+          }
+
+          cols += lnv.cols();
+
+          if (tcols <= text_width)
+          {
+            cols = std::max(cols, text_width);
+          }
+          else
+          {
+            cols = std::max(cols, text_width - 1);
+            fb.put(fx + cols, fy, '>', 1, fg, bg);
+            ++cols;
+          }
+
+          // subtract 1 to counter the for loops ++x condition
+          x += cols - 1;
+        }
+        else if (! transparent)
+        {
+          fg = fb.style(_color_fg.step());
+          fb.put(fx, fy, fill, fill_cols, fg, bg);
+        }
+      }
+    }
+
+    return *this;
+  }
+
   Rect& highlight(std::vector<std::pair<std::string, OB::Color>> const& hl)
   {
     _highlight = hl;
@@ -640,6 +912,10 @@ private:
   std::vector<std::pair<std::size_t, std::size_t>> _syntax;
   std::vector<std::pair<std::string, OB::Color>> _highlight;
 
+  // lines of the text, kept between framebuffer draws to reuse their storage
+  std::vector<std::string_view> _lines;
+  OB::Text::View _lnv;
+
   // border
   bool _border_top {false};
   bool _border_bottom {false};
@@ -0,0 +1,181 @@
+#ifndef OB_SINK_HH
+#define OB_SINK_HH
+
+#include <poll.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstddef>
+
+#include <string>
+#include <algorithm>
+#include <stdexcept>
+
+namespace OB
+{
+
+// output buffer reused between frames, its contents are handed to a file
+// descriptor with a single write call, bypassing the iostream buffers,
+// output a nonblocking descriptor cannot take yet stays queued
+class Sink
+{
+public:
+
+  struct Stats
+  {
+    // number of flushes
+    std::size_t frames {0};
+
+    // bytes written by the previous flush
+    std::size_t last {0};
+
+    // most bytes written by a single flush
+    std::size_t max {0};
+
+    // bytes written by all flushes
+    std::size_t total {0};
+
+    // frames skipped because the descriptor was still busy
+    std::size_t dropped {0};
+
+    std::size_t avg() const
+    {
+      return frames ? total / frames : 0;
+    }
+  }; // struct Stats
+
+  Sink(std::size_t const capacity = 1 << 16)
+  {
+    _buf.reserve(capacity);
+  }
+
+  Sink(Sink&&) = default;
+  Sink(Sink const&) = default;
+  ~Sink() = default;
+
+  Sink& operator=(Sink&&) = default;
+  Sink& operator=(Sink const&) = default;
+
+  // the buffered bytes, append to it to queue output
+  std::string& buf()
+  {
+    return _buf;
+  }
+
+  bool empty() const
+  {
+    return _pos == _buf.size();
+  }
+
+  // bytes queued by earlier flushes that the descriptor has not taken yet
+  std::size_t pending() const
+  {
+    return _mark - _pos;
+  }
+
+  // hand the bytes appended since the previous flush to the descriptor,
+  // on a nonblocking descriptor the part that would block is kept queued,
+  // returns true once everything has been written
+  bool flush(int const fd)
+  {
+    ++_stats.frames;
+    _stats.last = _buf.size() - _mark;
+    _stats.max = std::max(_stats.max, _stats.last);
+    _stats.total += _stats.last;
+
+    _mark = _buf.size();
+
+    return write(fd);
+  }
+
+  // continue writing the bytes queued by earlier flushes,
+  // returns true once everything has been written
+  bool resume(int const fd)
+  {
+    return write(fd);
+  }
+
+  // write out the queued bytes, waiting for the descriptor as needed
+  Sink& drain(int const fd)
+  {
+    while (! write(fd))
+    {
+      pollfd pfd {fd, POLLOUT, 0};
+
+      if (poll(&pfd, 1, -1) == -1 && errno != EINTR)
+      {
+        throw std::runtime_error("poll failed");
+      }
+    }
+
+    return *this;
+  }
+
+  // record a frame that was skipped while earlier output was still queued
+  Sink& drop()
+  {
+    ++_stats.dropped;
+
+    return *this;
+  }
+
+  Stats const& stats() const
+  {
+    return _stats;
+  }
+
+private:
+
+  // write as much of the queued bytes as the descriptor accepts
+  bool write(int const fd)
+  {
+    while (_pos < _mark)
+    {
+      auto const n = ::write(fd, _buf.data() + _pos, _mark - _pos);
+
+      if (n < 0)
+      {
+        if (errno == EINTR)
+        {
+          continue;
+        }
+
+#if EWOULDBLOCK != EAGAIN
+        if (errno == EAGAIN || errno == EWOULDBLOCK)
+#else
+        if (errno == EAGAIN)
+#endif
+        {
+          return false;
+        }
+
+        _buf.clear();
+        _pos = 0;
+        _mark = 0;
+
+        throw std::runtime_error("write failed");
+      }
+
+      _pos += static_cast<std::size_t>(n);
+    }
+
+    // everything written, reuse the buffer from the start
+    _buf.erase(0, _mark);
+    _pos = 0;
+    _mark = 0;
+
+    return true;
+  }
+
+  std::string _buf;
+
+  // write position and end of the bytes handed over by flush
+  std::size_t _pos {0};
+  std::size_t _mark {0};
+
+  Stats _stats;
+}; // class Sink
+
+} // namespace OB
+
+#endif // OB_SINK_HH
@@ -1,6 +1,7 @@
 #ifndef OB_TERM_HH
 #define OB_TERM_HH
 
+#include <poll.h>
 #include <unistd.h>
 #include <termios.h>
 #include <sys/ioctl.h>
@@ -17,6 +18,7 @@
 #include <sstream>
 #include <string>
 #include <string_view>
+#include <charconv>
 #include <vector>
 #include <regex>
 #include <chrono>
@@ -110,12 +112,52 @@ inline char32_t utf8_to_char32(std::string_view str)
   return 0;
 }
 
+// bytes read from stdin that belong to the input, such as keys pressed
+// while waiting for the reply to a terminal query, get_key reads them first
+inline std::string& input_queue()
+{
+  static std::string queue;
+
+  return queue;
+}
+
+// whether get_key has input to return without reading stdin
+inline bool input_pending()
+{
+  return ! input_queue().empty();
+}
+
+// read up to 'size' bytes, taking the queued input before stdin,
+// returns the number of bytes read or -1 on error when nothing was read
+inline int read_input(char* buf, std::size_t const size)
+{
+  auto& queue = input_queue();
+  auto const n = std::min(size, queue.size());
+
+  std::copy_n(queue.begin(), n, buf);
+  queue.erase(0, n);
+
+  if (n == size)
+  {
+    return static_cast<int>(n);
+  }
+
+  auto const ec = read(STDIN_FILENO, buf + n, size - n);
+
+  if (ec < 0)
+  {
+    return n ? static_cast<int>(n) : -1;
+  }
+
+  return static_cast<int>(n + static_cast<std::size_t>(ec));
+}
+
 inline char32_t get_key(std::string* str = nullptr)
 {
   // NOTE term mode should be in raw state before call to this func
 
   char key[4] {0};
-  int ec = read(STDIN_FILENO, &key[0], 1);
+  int ec = read_input(&key[0], 1);
 
   if ((ec == -1) && (errno != EAGAIN))
   {
@@ -140,7 +182,7 @@ inline char32_t get_key(std::string* str = nullptr)
       }
     }
 
-    if ((ec = read(STDIN_FILENO, &key[1], bytes)) != static_cast<int>(bytes))
+    if ((ec = read_input(&key[1], bytes)) != static_cast<int>(bytes))
     {
       if ((ec == -1) && (errno != EAGAIN))
       {
@@ -171,7 +213,7 @@ inline char32_t get_key(std::string* str = nullptr)
   {
     char seq[3] {0};
 
-    if ((ec = read(STDIN_FILENO, &seq[0], 1)) != 1)
+    if ((ec = read_input(&seq[0], 1)) != 1)
     {
       if ((ec == -1) && (errno != EAGAIN))
       {
@@ -181,7 +223,7 @@ inline char32_t get_key(std::string* str = nullptr)
       return static_cast<char32_t>(key[0]);
     }
 
-    if ((ec = read(STDIN_FILENO, &seq[1], 1)) != 1)
+    if ((ec = read_input(&seq[1], 1)) != 1)
     {
       if ((ec == -1) && (errno != EAGAIN))
       {
@@ -195,7 +237,7 @@ inline char32_t get_key(std::string* str = nullptr)
     {
       if (seq[1] >= '0' && seq[1] <= '9')
       {
-        if ((ec = read(STDIN_FILENO, &seq[2], 1)) != 1)
+        if ((ec = read_input(&seq[2], 1)) != 1)
         {
           if ((ec == -1) && (errno != EAGAIN))
           {
@@ -279,7 +321,7 @@ inline char32_t get_key(std::string* str = nullptr)
 
             for (std::size_t i = 0; i < buf_size; ++i)
             {
-              if ((ec = read(STDIN_FILENO, &mouse[i], 1)) != 1)
+              if ((ec = read_input(&mouse[i], 1)) != 1)
               {
                 if ((ec == -1) && (errno != EAGAIN))
                 {
@@ -396,7 +438,7 @@ inline char32_t get_key(std::string* str = nullptr)
 
             char mouse[3] {0};
 
-            if ((ec = read(STDIN_FILENO, &mouse[0], 3)) != 3)
+            if ((ec = read_input(&mouse[0], 3)) != 3)
             {
               if ((ec == -1) && (errno != EAGAIN))
               {
@@ -783,6 +825,10 @@ std::string const screen_push {esc + "[?1049h"};
 std::string const screen_pop {esc + "[?1049l"};
 std::string const screen_clear {esc + "[2J"};
 
+// synchronized output, the terminal holds back drawing between the two
+std::string const sync_begin {esc + "[?2026h"};
+std::string const sync_end {esc + "[?2026l"};
+
 // scroll
 std::string const scroll_up {esc + "M"};
 std::string const scroll_down {esc + "D"};
@@ -874,6 +920,85 @@ inline std::string cursor_set(std::size_t x_, std::size_t y_)
   return ss.str();
 }
 
+// append an unsigned integer in decimal to the buffer without a temporary
+inline std::string& append_num(std::string& buf_, std::size_t val_)
+{
+  char str[std::numeric_limits<std::size_t>::digits10 + 1];
+  auto const res = std::to_chars(str, str + sizeof(str), val_);
+  buf_.append(str, static_cast<std::size_t>(res.ptr - str));
+
+  return buf_;
+}
+
+// the following overloads append to a caller supplied buffer,
+// emitting the same sequences as their string returning counterparts
+
+inline std::string& cursor_up(std::string& buf_, std::size_t val = 1)
+{
+  if (val)
+  {
+    append_num(buf_.append("\x1b["), val) += 'A';
+  }
+
+  return buf_;
+}
+
+inline std::string& cursor_down(std::string& buf_, std::size_t val = 1)
+{
+  if (val)
+  {
+    append_num(buf_.append("\x1b["), val) += 'B';
+  }
+
+  return buf_;
+}
+
+inline std::string& cursor_right(std::string& buf_, std::size_t val = 1)
+{
+  if (val)
+  {
+    append_num(buf_.append("\x1b["), val) += 'C';
+  }
+
+  return buf_;
+}
+
+inline std::string& cursor_left(std::string& buf_, std::size_t val = 1)
+{
+  if (val)
+  {
+    append_num(buf_.append("\x1b["), val) += 'D';
+  }
+
+  return buf_;
+}
+
+inline std::string& cursor_set(std::string& buf_, std::size_t x_, std::size_t y_)
+{
+  append_num(buf_.append("\x1b["), y_) += ';';
+  append_num(buf_, x_) += 'H';
+
+  return buf_;
+}
+
+inline std::string& fg_true(std::string& buf_, std::uint8_t r_, std::uint8_t g_, std::uint8_t b_)
+{
+  append_num(buf_.append("\x1b[38;2;"), r_) += ';';
+  append_num(buf_, g_) += ';';
+  append_num(buf_, b_) += 'm';
+
+  return buf_;
+}
+
+inline std::string& bg_true(std::string& buf_, std::uint8_t r_, std::uint8_t g_, std::uint8_t b_)
+{
+  append_num(buf_.append("\x1b[48;2;"), r_) += ';';
+  append_num(buf_, g_) += ';';
+  append_num(buf_, b_) += 'm';
+
+  return buf_;
+}
+
 inline int cursor_get(std::size_t& x_, std::size_t& y_, bool mode_ = true)
 {
   Term::Mode mode;
@@ -921,6 +1046,144 @@ inline int cursor_get(std::size_t& x_, std::size_t& y_, bool mode_ = true)
   return 0;
 }
 
+// query the state of a private mode with DECRQM, followed by a primary device
+// attributes request that every terminal answers, so that a terminal without
+// DECRQM support is detected without waiting for the whole timeout,
+// returns -1 when there is no reply, otherwise the DECRPM value,
+// 0 not recognized, 1 set, 2 reset, 3 permanently set, 4 permanently reset,
+// other input read while waiting is queued for get_key
+inline int mode_get(std::size_t mode_, bool raw_ = true, int timeout_ = 250)
+{
+  Term::Mode mode;
+
+  if (raw_)
+  {
+    mode.set_raw();
+  }
+
+  std::cout << esc << "[?" << mode_ << "$p" << esc << "[c" << std::flush;
+
+  // match a reply, CSI ? Ps ; Pm $ y or CSI ? Ps ; ... c,
+  // returns 0 when it is not a reply, 1 while partial, 2 once complete
+  auto const match = [](std::string const& seq) {
+    std::string_view const csi {"\x1b[?"};
+
+    if (seq.size() <= csi.size())
+    {
+      return csi.substr(0, seq.size()) == seq ? 1 : 0;
+    }
+
+    if (seq.compare(0, csi.size(), csi) != 0)
+    {
+      return 0;
+    }
+
+    auto const last = seq.size() - 1;
+
+    for (std::size_t i = csi.size(); i < last; ++i)
+    {
+      if (! std::isdigit(static_cast<unsigned char>(seq[i])) && seq[i] != ';')
+      {
+        return seq[i] == '$' && i + 1 == last && seq[last] == 'y' ? 2 : 0;
+      }
+    }
+
+    if (std::isdigit(static_cast<unsigned char>(seq[last])) || seq[last] == ';' || seq[last] == '$')
+    {
+      return 1;
+    }
+
+    return seq[last] == 'c' ? 2 : 0;
+  };
+
+  auto const end = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_);
+  auto& queue = input_queue();
+  std::string seq;
+  int res {-1};
+
+  while (true)
+  {
+    auto const left = std::chrono::duration_cast<std::chrono::milliseconds>(
+      end - std::chrono::steady_clock::now()).count();
+
+    if (left <= 0)
+    {
+      break;
+    }
+
+    pollfd pfd {STDIN_FILENO, POLLIN, 0};
+
+    if (poll(&pfd, 1, static_cast<int>(left)) != 1)
+    {
+      continue;
+    }
+
+    char ch;
+
+    if (read(STDIN_FILENO, &ch, 1) != 1)
+    {
+      continue;
+    }
+
+    seq += ch;
+
+    auto const state = match(seq);
+
+    if (state == 0)
+    {
+      // not a reply, keep it as input, an escape may start the reply
+      if (ch == '\x1b')
+      {
+        queue.append(seq, 0, seq.size() - 1);
+        seq = ch;
+      }
+      else
+      {
+        queue += seq;
+        seq.clear();
+      }
+
+      continue;
+    }
+
+    if (state == 1)
+    {
+      continue;
+    }
+
+    // mode report
+    if (seq.back() == 'y')
+    {
+      std::size_t num;
+      int val;
+
+      if (std::sscanf(&seq[3], "%zu;%d$y", &num, &val) == 2 && num == mode_)
+      {
+        res = val;
+      }
+
+      seq.clear();
+
+      continue;
+    }
+
+    // device attributes, the reply to the last request
+    if (res == -1)
+    {
+      res = 0;
+    }
+
+    seq.clear();
+
+    break;
+  }
+
+  // a reply cut off by the timeout is left as input
+  queue += seq;
+
+  return res;
+}
+
 inline std::string str_to_fg_color(std::string const& str_, bool bright_ = false)
 {
   if ("black" == str_)
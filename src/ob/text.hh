@@ -128,80 +128,46 @@ public:
       return *this;
     }
 
-    UErrorCode ec = U_ZERO_ERROR;
-
-    std::unique_ptr<UText, decltype(&utext_close)> text (
-      utext_openUTF8(nullptr, str.data(), static_cast<std::int64_t>(str.size()), &ec),
-      utext_close);
-
-    if (U_FAILURE(ec))
+    // pure 7-bit text, every byte is a single column grapheme
+    // except for a carriage return line feed pair
+    if (std::all_of(str.begin(), str.end(),
+      [](char_type const ch) { return static_cast<unsigned char>(ch) < 0x80; }))
     {
-      throw std::runtime_error("failed to create utext");
-    }
+      _view.reserve(str.size());
 
-    std::unique_ptr<brk_iter> iter {brk_iter::createCharacterInstance(
-      locale::getDefault(), ec)};
+      for (size_type i = 0; i < str.size(); ++i)
+      {
+        size_type const size {(str[i] == '\r' && i + 1 < str.size() && str[i + 1] == '\n') ? 2ul : 1ul};
 
-    if (U_FAILURE(ec))
-    {
-      throw std::runtime_error("failed to create break iterator");
-    }
+        _view.emplace_back(_bytes, _cols, 1, string_view(str.data() + i, size));
 
-    iter->setText(text.get(), ec);
+        _cols += 1;
+        _bytes += size;
+        i += size - 1;
+      }
 
-    if (U_FAILURE(ec))
-    {
-      throw std::runtime_error("failed to set break iterator text");
+      return *this;
     }
 
-    // get size of iterator
-    size_type size {0};
-    while (iter->next() != iter_end)
+    // grapheme boundaries and widths are cached by content,
+    // the same fills and dates are segmented every frame
+    auto& entry = cache().at(std::hash<string_view>{}(str) % cache_size);
+
+    if (string_view(entry.str) != str)
     {
-      ++size;
+      entry.str.clear();
+      segment(str, entry.seg);
+      entry.str = str;
     }
 
-    // reserve array size
-    _view.reserve(size);
-
-    size = 0;
-    UChar32 uch;
-    int width {0};
-    size_type cols {0};
-    auto begin = iter->first();
-    auto end = iter->next();
+    _view.reserve(entry.seg.size());
 
-    while (end != iter_end)
+    for (auto const& [size, cols] : entry.seg)
     {
-      // get column width
-      uch = utext_char32At(text.get(), begin);
-      width = u_getIntPropertyValue(uch, UCHAR_EAST_ASIAN_WIDTH);
-      if (width == U_EA_FULLWIDTH || width == U_EA_WIDE)
-      {
-        // full width
-        cols = 2;
-      }
-      else
-      {
-        // half width
-        cols = 1;
-      }
-
-      // get string size
-      size = static_cast<size_type>(end - begin);
-
-      // add character context to array
       _view.emplace_back(_bytes, _cols, cols, string_view(str.data() + (_bytes * sizeof(char_type)), size));
 
-      // increase total column count
       _cols += cols;
-
-      // increase total byte count
       _bytes += size;
-
-      // increase iterators
-      begin = end;
-      end = iter->next();
     }
 
     return *this;
@@ -634,6 +600,124 @@ public:
 
 private:
 
+  // byte size and column width of each grapheme
+  using Segment = std::vector<std::pair<size_type, size_type>>;
+
+  struct Entry
+  {
+    string str;
+    Segment seg;
+  }; // struct Entry
+
+  // number of strings kept in the segmentation cache
+  static size_type constexpr cache_size {64};
+
+  // direct mapped segmentation cache, one per thread
+  static std::array<Entry, cache_size>& cache()
+  {
+    thread_local std::array<Entry, cache_size> cache;
+
+    return cache;
+  }
+
+  // split a string into graphemes
+  static void segment(string_view str, Segment& seg)
+  {
+    seg.clear();
+
+    UErrorCode ec = U_ZERO_ERROR;
+
+    // reuse the thread's utext and break iterator, creating them is expensive
+    auto& text = utext();
+    utext_openUTF8(&text, str.data(), static_cast<std::int64_t>(str.size()), &ec);
+
+    if (U_FAILURE(ec))
+    {
+      throw std::runtime_error("failed to create utext");
+    }
+
+    auto& iter = break_iterator();
+    iter.setText(&text, ec);
+
+    if (U_FAILURE(ec))
+    {
+      throw std::runtime_error("failed to set break iterator text");
+    }
+
+    size_type size {0};
+    UChar32 uch;
+    int width {0};
+    size_type cols {0};
+    auto begin = iter.first();
+    auto end = iter.next();
+
+    while (end != iter_end)
+    {
+      // get column width
+      uch = utext_char32At(&text, begin);
+      width = u_getIntPropertyValue(uch, UCHAR_EAST_ASIAN_WIDTH);
+      if (width == U_EA_FULLWIDTH || width == U_EA_WIDE)
+      {
+        // full width
+        cols = 2;
+      }
+      else
+      {
+        // half width
+        cols = 1;
+      }
+
+      // get string size
+      size = static_cast<size_type>(end - begin);
+
+      // add byte size and column width to array
+      seg.emplace_back(size, cols);
+
+      // increase iterators
+      begin = end;
+      end = iter.next();
+    }
+  }
+
+  // utext reopened over each new string on the calling thread
+  static UText& utext()
+  {
+    struct Text
+    {
+      ~Text()
+      {
+        utext_close(&value);
+      }
+
+      UText value = UTEXT_INITIALIZER;
+    }; // struct Text
+
+    thread_local Text text;
+
+    return text.value;
+  }
+
+  // character break iterator created once per thread and reset with setText
+  static brk_iter& break_iterator()
+  {
+    thread_local std::unique_ptr<brk_iter> const iter {[]()
+    {
+      UErrorCode ec = U_ZERO_ERROR;
+
+      std::unique_ptr<brk_iter> res {brk_iter::createCharacterInstance(
+        locale::getDefault(), ec)};
+
+      if (U_FAILURE(ec))
+      {
+        throw std::runtime_error("failed to create break iterator");
+      }
+
+      return res;
+    }()};
+
+    return *iter;
+  }
+
   // array of contexts mapping the string
   value_type _view;
 
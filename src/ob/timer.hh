@@ -14,13 +14,17 @@
 namespace OB
 {
 
+// measures elapsed time on the monotonic clock,
+// so changes to the system time do not affect a running timer
 class Timer
 {
 public:
 
+  using clock = std::chrono::steady_clock;
+
   Timer() = default;
 
-  operator bool()
+  operator bool() const
   {
     return _is_running;
   }
@@ -28,7 +32,7 @@ public:
   Timer& start()
   {
     _is_running = true;
-    _start = std::chrono::high_resolution_clock::now();
+    _start = clock::now();
 
     return *this;
   }
@@ -59,73 +63,64 @@ public:
     else
     {
       _is_running = true;
-      _start = std::chrono::high_resolution_clock::now();
+      _start = clock::now();
     }
 
     return *this;
   }
 
-  template<typename T>
-  T time()
+  // total running time, including the current run
+  clock::duration elapsed() const
   {
-    if (_is_running)
-    {
-      update();
-    }
-
-    return std::chrono::duration_cast<T>(_total);
+    return _is_running ? _total + (clock::now() - _start) : _total;
   }
 
-  std::tuple<int, int, int> diff(long int const sec)
+  template<typename T>
+  T time() const
   {
-    if (_is_running)
-    {
-      update();
-    }
-
-    long int const now {static_cast<long int>(std::chrono::time_point_cast<std::chrono::seconds>(_total).time_since_epoch().count())};
-
-    return seconds_to_hms(sec - now);
+    return std::chrono::duration_cast<T>(elapsed());
   }
 
-  long int seconds()
+  // time until the elapsed time reaches the next multiple of step,
+  // when a display showing whole steps changes
+  clock::duration next(clock::duration const step = std::chrono::seconds(1)) const
   {
-    if (_is_running)
-    {
-      update();
-    }
-
-    return static_cast<long int>(std::chrono::time_point_cast<std::chrono::seconds>(_total).time_since_epoch().count());
+    return step - (elapsed() % step);
   }
 
-  std::tuple<int, int, int> hms()
+  std::tuple<int, int, int> diff(long int const sec) const
   {
-    if (_is_running)
-    {
-      update();
-    }
+    return seconds_to_hms(sec - seconds());
+  }
 
-    long int const diff {static_cast<long int>(std::chrono::time_point_cast<std::chrono::seconds>(_total).time_since_epoch().count())};
+  long int seconds() const
+  {
+    return static_cast<long int>(time<std::chrono::seconds>().count());
+  }
 
-    return seconds_to_hms(diff);
+  std::tuple<int, int, int> hms() const
+  {
+    return seconds_to_hms(seconds());
   }
 
-  std::string str()
+  // hours, minutes, seconds, and milliseconds, read at a single instant
+  std::tuple<int, int, int, int> hms_ms() const
   {
-    if (_is_running)
-    {
-      update();
-    }
+    auto const msec = static_cast<long int>(time<std::chrono::milliseconds>().count());
+    auto const [hour, minute, second] = seconds_to_hms(msec / 1000);
 
-    long int const diff {static_cast<long int>(std::chrono::time_point_cast<std::chrono::seconds>(_total).time_since_epoch().count())};
+    return {hour, minute, second, static_cast<int>(msec % 1000)};
+  }
 
-    return seconds_to_string(diff);
+  std::string str() const
+  {
+    return seconds_to_string(seconds());
   }
 
   void str(std::string const& str)
   {
     reset();
-    _total = std::chrono::time_point<std::chrono::high_resolution_clock>(string_to_seconds(str));
+    _total = string_to_seconds(str);
   }
 
   static long int str_to_sec(std::string const& str)
@@ -298,19 +293,14 @@ private:
 
   void update()
   {
-    auto const stop = std::chrono::high_resolution_clock::now();
-
-    if (stop > _start)
-    {
-      _total += (stop - _start);
-    }
-
+    auto const stop = clock::now();
+    _total += stop - _start;
     _start = stop;
   }
 
   bool _is_running {false};
-  std::chrono::time_point<std::chrono::high_resolution_clock> _start;
-  std::chrono::time_point<std::chrono::high_resolution_clock> _total;
+  clock::time_point _start;
+  clock::duration _total {0};
 }; // class Timer
 
 } // namespace OB
@@ -0,0 +1,804 @@
+#ifndef OB_TIMEZONE_HH
+#define OB_TIMEZONE_HH
+
+#include <ctime>
+#include <cstdint>
+#include <cstdlib>
+#include <cstddef>
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <fstream>
+#include <iterator>
+#include <algorithm>
+#include <limits>
+#include <optional>
+
+namespace OB
+{
+
+// timezone loaded once from a zoneinfo file or a POSIX TZ string,
+// converts utc time to local time without the C library or the environment,
+// the offset in effect is cached until the next transition
+class Timezone
+{
+public:
+
+  // UTC, without reading any file or the environment
+  Timezone()
+  {
+    _types.emplace_back(Type());
+  }
+
+  // a zone loaded by name, see load
+  explicit Timezone(std::string const& name)
+  {
+    load(name);
+  }
+
+  Timezone(Timezone&&) = default;
+  Timezone(Timezone const&) = default;
+  ~Timezone() = default;
+
+  Timezone& operator=(Timezone&&) = default;
+  Timezone& operator=(Timezone const&) = default;
+
+  // load a zone by name, such as 'Europe/Paris', a zoneinfo path,
+  // or a POSIX TZ string, an empty name selects the system zone,
+  // returns false and falls back to UTC if the zone is not found
+  bool load(std::string const& name)
+  {
+    _name = name;
+    _times.clear();
+    _index.clear();
+    _types.clear();
+    _rule.reset();
+
+    // empty the cached range
+    _type = 0;
+    _begin = max_time;
+    _end = min_time;
+
+    std::string tz {name};
+
+    if (tz.empty())
+    {
+      if (char const* env = std::getenv("TZ"))
+      {
+        tz = env;
+
+        // set but empty means UTC
+        if (tz.empty())
+        {
+          _types.emplace_back(Type());
+
+          return true;
+        }
+      }
+      else
+      {
+        tz = "/etc/localtime";
+      }
+    }
+
+    if (tz.front() == ':')
+    {
+      tz.erase(0, 1);
+    }
+
+    if (! tz.empty())
+    {
+      std::string path {tz};
+
+      if (path.front() != '/')
+      {
+        char const* dir = std::getenv("TZDIR");
+        path = std::string(dir ? dir : "/usr/share/zoneinfo") + "/" + path;
+      }
+
+      if (read_tzif(path))
+      {
+        return true;
+      }
+
+      _times.clear();
+      _index.clear();
+      _types.clear();
+
+      if (auto rule = parse_rule(tz))
+      {
+        set_rule(rule.value());
+
+        return true;
+      }
+    }
+
+    _types.emplace_back(Type());
+
+    return false;
+  }
+
+  std::string const& name() const
+  {
+    return _name;
+  }
+
+  // utc offset in seconds at a utc time
+  std::int32_t offset(std::time_t const time)
+  {
+    return type(time).offset;
+  }
+
+  // broken down local time of a utc time, tm_zone points into the types
+  // of this zone and stays valid until it is loaded again or destroyed
+  std::tm local(std::time_t const time)
+  {
+    auto const& t = type(time);
+    auto const secs = static_cast<std::int64_t>(time) + t.offset;
+    auto const days = floor_div(secs, 86400);
+    auto const rem = secs - (days * 86400);
+
+    int year {0};
+    int month {0};
+    int day {0};
+    civil_from_days(days, year, month, day);
+
+    std::tm tm {};
+    tm.tm_sec = static_cast<int>(rem % 60);
+    tm.tm_min = static_cast<int>((rem / 60) % 60);
+    tm.tm_hour = static_cast<int>(rem / 3600);
+    tm.tm_mday = day;
+    tm.tm_mon = month - 1;
+    tm.tm_year = year - 1900;
+    tm.tm_wday = static_cast<int>(floor_mod(days + 4, 7));
+    tm.tm_yday = static_cast<int>(days - days_from_civil(year, 1, 1));
+    tm.tm_isdst = t.dst;
+    tm.tm_gmtoff = t.offset;
+    tm.tm_zone = t.abbr.c_str();
+
+    return tm;
+  }
+
+private:
+
+  static constexpr std::int64_t min_time {std::numeric_limits<std::int64_t>::min()};
+  static constexpr std::int64_t max_time {std::numeric_limits<std::int64_t>::max()};
+
+  // local time type
+  struct Type
+  {
+    std::int32_t offset {0};
+    bool dst {false};
+    std::string abbr {"UTC"};
+  };
+
+  // POSIX TZ string, as found in the footer of a zoneinfo file
+  struct Rule
+  {
+    // day of the year a transition happens on, and the local time of day
+    struct Date
+    {
+      enum Kind
+      {
+        julian,
+        zero,
+        month,
+      };
+
+      Kind kind {month};
+      int m {0};
+      int w {0};
+      int d {0};
+      std::int32_t time {7200};
+    };
+
+    Type standard;
+    std::optional<Type> daylight;
+
+    Date start;
+    Date end;
+  };
+
+  // local time type at a utc time, looked up only when the time leaves
+  // the range of the previous lookup
+  Type const& type(std::time_t const time)
+  {
+    auto const t = static_cast<std::int64_t>(time);
+
+    if (t >= _begin && t < _end)
+    {
+      return _types.at(_type);
+    }
+
+    auto const it = std::upper_bound(_times.begin(), _times.end(), t);
+    auto const idx = static_cast<std::size_t>(std::distance(_times.begin(), it));
+
+    if (it != _times.end())
+    {
+      // before the first transition the first type applies
+      _type = idx ? _index.at(idx - 1) : 0;
+      _begin = idx ? _times.at(idx - 1) : min_time;
+      _end = *it;
+    }
+    else if (_rule)
+    {
+      rule_type(t, _times.empty() ? min_time : _times.back());
+    }
+    else
+    {
+      _type = _times.empty() ? 0 : _index.back();
+      _begin = _times.empty() ? min_time : _times.back();
+      _end = max_time;
+    }
+
+    return _types.at(_type);
+  }
+
+  // local time type of the POSIX rule at a utc time, no earlier than floor
+  void rule_type(std::int64_t const t, std::int64_t const floor)
+  {
+    auto const& rule = _rule.value();
+    auto const standard = _rule_type;
+    auto const daylight = _rule_type + 1;
+
+    if (! rule.daylight)
+    {
+      _type = standard;
+      _begin = floor;
+      _end = max_time;
+
+      return;
+    }
+
+    // the transitions of the surrounding years, in utc
+    int year {0};
+    int month {0};
+    int day {0};
+    civil_from_days(floor_div(t + rule.standard.offset, 86400), year, month, day);
+
+    std::vector<std::pair<std::int64_t, std::size_t>> points;
+
+    for (int y = year - 1; y <= year + 1; ++y)
+    {
+      points.emplace_back(transition(y, rule.start) - rule.standard.offset, daylight);
+      points.emplace_back(transition(y, rule.end) - rule.daylight->offset, standard);
+    }
+
+    std::sort(points.begin(), points.end(),
+      [](auto const& lhs, auto const& rhs) { return lhs.first < rhs.first; });
+
+    auto const it = std::upper_bound(points.begin(), points.end(), t,
+      [](auto const val, auto const& point) { return val < point.first; });
+
+    if (it == points.begin())
+    {
+      _type = it->second == standard ? daylight : standard;
+      _begin = floor;
+    }
+    else
+    {
+      _type = std::prev(it)->second;
+      _begin = std::max(std::prev(it)->first, floor);
+    }
+
+    _end = it != points.end() ? it->first : max_time;
+  }
+
+  // seconds from the epoch to a transition in a year, in local time
+  static std::int64_t transition(int const year, Rule::Date const& date)
+  {
+    auto days = days_from_civil(year, 1, 1);
+
+    switch (date.kind)
+    {
+      // day 1 to 365, february 29 is never counted
+      case Rule::Date::julian:
+      {
+        days += date.d - 1 + (leap(year) && date.d >= 60 ? 1 : 0);
+
+        break;
+      }
+
+      // day 0 to 365
+      case Rule::Date::zero:
+      {
+        days += date.d;
+
+        break;
+      }
+
+      // day d of week w of month m, week 5 is the last one
+      case Rule::Date::month:
+      {
+        days = days_from_civil(year, date.m, 1);
+        auto const wday = floor_mod(days + 4, 7);
+        auto mday = 1 + floor_mod(date.d - wday, 7) + ((date.w - 1) * 7);
+
+        while (mday > month_days(year, date.m))
+        {
+          mday -= 7;
+        }
+
+        days += mday - 1;
+
+        break;
+      }
+
+      default:
+      {
+        break;
+      }
+    }
+
+    return (days * 86400) + date.time;
+  }
+
+  bool read_tzif(std::string const& path)
+  {
+    std::ifstream file {path, std::ios::binary};
+
+    if (! file)
+    {
+      return false;
+    }
+
+    std::string const buf {std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+    std::string_view str {buf};
+
+    struct Header
+    {
+      std::size_t version {0};
+      std::size_t isutcnt {0};
+      std::size_t isstdcnt {0};
+      std::size_t leapcnt {0};
+      std::size_t timecnt {0};
+      std::size_t typecnt {0};
+      std::size_t charcnt {0};
+    };
+
+    auto const header = [&](Header& h) {
+      if (str.size() < 44 || str.substr(0, 4) != "TZif")
+      {
+        return false;
+      }
+
+      h.version = str[4] ? static_cast<std::size_t>(str[4] - '0') : 1;
+      h.isutcnt = be32(str.data() + 20);
+      h.isstdcnt = be32(str.data() + 24);
+      h.leapcnt = be32(str.data() + 28);
+      h.timecnt = be32(str.data() + 32);
+      h.typecnt = be32(str.data() + 36);
+      h.charcnt = be32(str.data() + 40);
+      str.remove_prefix(44);
+
+      return true;
+    };
+
+    auto const data_size = [](Header const& h, std::size_t const time_size) {
+      return (h.timecnt * time_size) + h.timecnt + (h.typecnt * 6) + h.charcnt +
+        (h.leapcnt * (time_size + 4)) + h.isstdcnt + h.isutcnt;
+    };
+
+    Header h;
+
+    if (! header(h))
+    {
+      return false;
+    }
+
+    std::size_t time_size {4};
+
+    // skip the 32 bit data of version 2 and later files
+    if (h.version >= 2)
+    {
+      if (str.size() < data_size(h, 4))
+      {
+        return false;
+      }
+
+      str.remove_prefix(data_size(h, 4));
+
+      if (! header(h))
+      {
+        return false;
+      }
+
+      time_size = 8;
+    }
+
+    if (h.typecnt == 0 || str.size() < data_size(h, time_size))
+    {
+      return false;
+    }
+
+    auto const* ptr = str.data();
+
+    for (std::size_t i = 0; i < h.timecnt; ++i, ptr += time_size)
+    {
+      _times.emplace_back(time_size == 8 ? static_cast<std::int64_t>(be64(ptr)) :
+        static_cast<std::int64_t>(static_cast<std::int32_t>(be32(ptr))));
+    }
+
+    for (std::size_t i = 0; i < h.timecnt; ++i, ++ptr)
+    {
+      auto const idx = static_cast<std::uint8_t>(*ptr);
+
+      if (idx >= h.typecnt)
+      {
+        return false;
+      }
+
+      _index.emplace_back(idx);
+    }
+
+    auto const* const chars = ptr + (h.typecnt * 6);
+
+    for (std::size_t i = 0; i < h.typecnt; ++i, ptr += 6)
+    {
+      Type type;
+      type.offset = static_cast<std::int32_t>(be32(ptr));
+      type.dst = ptr[4] != 0;
+
+      auto const idx = static_cast<std::uint8_t>(ptr[5]);
+
+      if (idx >= h.charcnt)
+      {
+        return false;
+      }
+
+      std::string_view const abbr {chars + idx, h.charcnt - idx};
+      type.abbr = std::string(abbr.substr(0, abbr.find('\0')));
+
+      _types.emplace_back(type);
+    }
+
+    str.remove_prefix(data_size(h, time_size));
+
+    // the footer holds the rule for times after the last transition
+    if (h.version >= 2 && str.size() > 1 && str.front() == '\n')
+    {
+      str.remove_prefix(1);
+      auto const footer = str.substr(0, str.find('\n'));
+
+      if (! footer.empty())
+      {
+        if (auto rule = parse_rule(footer))
+        {
+          set_rule(rule.value());
+        }
+      }
+    }
+
+    return true;
+  }
+
+  // rule for the times after the last transition, its types are added
+  // to the table so that every cached type has a stable abbreviation
+  void set_rule(Rule const& rule)
+  {
+    _rule = rule;
+    _rule_type = _types.size();
+    _types.emplace_back(rule.standard);
+
+    if (rule.daylight)
+    {
+      _types.emplace_back(rule.daylight.value());
+    }
+  }
+
+  // parse a POSIX TZ string, such as 'CET-1CEST,M3.5.0,M10.5.0/3'
+  static std::optional<Rule> parse_rule(std::string_view str)
+  {
+    Rule rule;
+
+    auto const name = [&](std::string& res) {
+      if (! str.empty() && str.front() == '<')
+      {
+        auto const end = str.find('>');
+
+        if (end == std::string_view::npos)
+        {
+          return false;
+        }
+
+        res = std::string(str.substr(1, end - 1));
+        str.remove_prefix(end + 1);
+
+        return ! res.empty();
+      }
+
+      std::size_t n {0};
+
+      while (n < str.size() && ((str[n] >= 'a' && str[n] <= 'z') || (str[n] >= 'A' && str[n] <= 'Z')))
+      {
+        ++n;
+      }
+
+      res = std::string(str.substr(0, n));
+      str.remove_prefix(n);
+
+      return n >= 3;
+    };
+
+    // [+-]hh[:mm[:ss]]
+    auto const duration = [&](std::int32_t& res) {
+      int sign {1};
+
+      if (! str.empty() && (str.front() == '+' || str.front() == '-'))
+      {
+        sign = str.front() == '-' ? -1 : 1;
+        str.remove_prefix(1);
+      }
+
+      std::int32_t val {0};
+
+      for (std::int32_t unit : {3600, 60, 1})
+      {
+        if (unit != 3600)
+        {
+          if (str.empty() || str.front() != ':')
+          {
+            break;
+          }
+
+          str.remove_prefix(1);
+        }
+
+        std::size_t n {0};
+        std::int32_t part {0};
+
+        while (n < str.size() && n < 3 && str[n] >= '0' && str[n] <= '9')
+        {
+          part = (part * 10) + (str[n] - '0');
+          ++n;
+        }
+
+        if (n == 0)
+        {
+          return false;
+        }
+
+        str.remove_prefix(n);
+        val += part * unit;
+      }
+
+      res = sign * val;
+
+      return true;
+    };
+
+    // Jn, n, or Mm.w.d, followed by an optional /time
+    auto const date = [&](Rule::Date& res) {
+      auto const number = [&](int& val) {
+        std::size_t n {0};
+        val = 0;
+
+        while (n < str.size() && n < 3 && str[n] >= '0' && str[n] <= '9')
+        {
+          val = (val * 10) + (str[n] - '0');
+          ++n;
+        }
+
+        str.remove_prefix(n);
+
+        return n > 0;
+      };
+
+      if (str.empty())
+      {
+        return false;
+      }
+
+      if (str.front() == 'J')
+      {
+        str.remove_prefix(1);
+        res.kind = Rule::Date::julian;
+
+        if (! number(res.d) || res.d < 1 || res.d > 365)
+        {
+          return false;
+        }
+      }
+      else if (str.front() == 'M')
+      {
+        str.remove_prefix(1);
+        res.kind = Rule::Date::month;
+
+        if (! number(res.m) || res.m < 1 || res.m > 12 ||
+          str.empty() || str.front() != '.')
+        {
+          return false;
+        }
+
+        str.remove_prefix(1);
+
+        if (! number(res.w) || res.w < 1 || res.w > 5 ||
+          str.empty() || str.front() != '.')
+        {
+          return false;
+        }
+
+        str.remove_prefix(1);
+
+        if (! number(res.d) || res.d > 6)
+        {
+          return false;
+        }
+      }
+      else
+      {
+        res.kind = Rule::Date::zero;
+
+        if (! number(res.d) || res.d > 365)
+        {
+          return false;
+        }
+      }
+
+      if (! str.empty() && str.front() == '/')
+      {
+        str.remove_prefix(1);
+
+        return duration(res.time);
+      }
+
+      return true;
+    };
+
+    std::int32_t offset {0};
+
+    if (! name(rule.standard.abbr))
+    {
+      return {};
+    }
+
+    // a bare UTC or GMT, as used when there is no zoneinfo database
+    if (str.empty() && (rule.standard.abbr == "UTC" || rule.standard.abbr == "GMT"))
+    {
+      return rule;
+    }
+
+    if (! duration(offset))
+    {
+      return {};
+    }
+
+    // the string counts hours west of utc
+    rule.standard.offset = -offset;
+
+    if (str.empty())
+    {
+      return rule;
+    }
+
+    Type dst;
+    dst.dst = true;
+    dst.offset = rule.standard.offset + 3600;
+
+    if (! name(dst.abbr))
+    {
+      return {};
+    }
+
+    if (! str.empty() && str.front() != ',')
+    {
+      if (! duration(offset))
+      {
+        return {};
+      }
+
+      dst.offset = -offset;
+    }
+
+    rule.daylight = dst;
+
+    if (str.empty())
+    {
+      // the default rule of the C library, the US one
+      rule.start = {Rule::Date::month, 3, 2, 0, 7200};
+      rule.end = {Rule::Date::month, 11, 1, 0, 7200};
+
+      return rule;
+    }
+
+    str.remove_prefix(1);
+
+    if (! date(rule.start) || str.empty() || str.front() != ',')
+    {
+      return {};
+    }
+
+    str.remove_prefix(1);
+
+    if (! date(rule.end) || ! str.empty())
+    {
+      return {};
+    }
+
+    return rule;
+  }
+
+  static std::uint32_t be32(char const* const ptr)
+  {
+    auto const* const p = reinterpret_cast<unsigned char const*>(ptr);
+
+    return (static_cast<std::uint32_t>(p[0]) << 24) | (static_cast<std::uint32_t>(p[1]) << 16) |
+      (static_cast<std::uint32_t>(p[2]) << 8) | static_cast<std::uint32_t>(p[3]);
+  }
+
+  static std::uint64_t be64(char const* const ptr)
+  {
+    return (static_cast<std::uint64_t>(be32(ptr)) << 32) | be32(ptr + 4);
+  }
+
+  static constexpr std::int64_t floor_div(std::int64_t const lhs, std::int64_t const rhs)
+  {
+    return (lhs / rhs) - ((lhs % rhs) < 0 ? 1 : 0);
+  }
+
+  static constexpr std::int64_t floor_mod(std::int64_t const lhs, std::int64_t const rhs)
+  {
+    return lhs - (floor_div(lhs, rhs) * rhs);
+  }
+
+  static constexpr bool leap(int const year)
+  {
+    return (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+  }
+
+  static constexpr int month_days(int const year, int const month)
+  {
+    return month == 2 ? (leap(year) ? 29 : 28) :
+      (month == 4 || month == 6 || month == 9 || month == 11) ? 30 : 31;
+  }
+
+  // days from the epoch to a date of the proleptic gregorian calendar
+  static constexpr std::int64_t days_from_civil(std::int64_t year, int const month, int const day)
+  {
+    year -= month <= 2;
+    auto const era = floor_div(year, 400);
+    auto const yoe = year - (era * 400);
+    auto const doy = ((153 * (month > 2 ? month - 3 : month + 9)) + 2) / 5 + day - 1;
+    auto const doe = (yoe * 365) + (yoe / 4) - (yoe / 100) + doy;
+
+    return (era * 146097) + doe - 719468;
+  }
+
+  // date of the proleptic gregorian calendar from days since the epoch
+  static void civil_from_days(std::int64_t days, int& year, int& month, int& day)
+  {
+    days += 719468;
+    auto const era = floor_div(days, 146097);
+    auto const doe = days - (era * 146097);
+    auto const yoe = (doe - (doe / 1460) + (doe / 36524) - (doe / 146096)) / 365;
+    auto const doy = doe - ((365 * yoe) + (yoe / 4) - (yoe / 100));
+    auto const mp = ((5 * doy) + 2) / 153;
+
+    // mp counts months from march, 0 to 11
+    day = static_cast<int>(doy - (((153 * mp) + 2) / 5) + 1);
+    month = static_cast<int>(((static_cast<std::uint32_t>(mp) + 2) % 12) + 1);
+    year = static_cast<int>(yoe + (era * 400) + (month <= 2));
+  }
+
+  std::string _name;
+
+  // transition times in utc and the type that starts at each one
+  std::vector<std::int64_t> _times;
+  std::vector<std::uint8_t> _index;
+  std::vector<Type> _types;
+
+  // rule for the times after the last transition, and the index
+  // of its standard type, the daylight type follows it
+  std::optional<Rule> _rule;
+  std::size_t _rule_type {0};
+
+  // index of the type in effect over the utc range begin to end
+  std::size_t _type {0};
+  std::int64_t _begin {max_time};
+  std::int64_t _end {min_time};
+}; // class Timezone
+
+} // namespace OB
+
+#endif // OB_TIMEZONE_HH
@@ -8,11 +8,16 @@ using Rect = OB::Rect;
 #include "ob/term.hh"
 namespace aec = OB::Term::ANSI_Escape_Codes;
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
 #include <ctime>
 #include <cstddef>
 #include <cstdlib>
 
 #include <string>
+#include <charconv>
 #include <sstream>
 #include <iostream>
 #include <vector>
@@ -22,13 +27,90 @@ namespace aec = OB::Term::ANSI_Escape_Codes;
 
 void Peaclock::init_ctx(std::size_t const width, std::size_t const height)
 {
-  _ctx = Ctx();
+  Layout const layout {width, height, cfg.view, cfg.seconds, fraction(), cfg.date,
+    cfg.auto_size, cfg.auto_ratio, cfg.x_block.get(), cfg.y_block.get(),
+    cfg.x_ratio.get(), cfg.y_ratio.get(), cfg.x_border.get(), cfg.y_border.get(),
+    cfg.x_space.get(), cfg.y_space.get(), cfg.date_padding.get(), date_lines(),
+    cfg.fill_active, cfg.fill_inactive, cfg.fill_colon};
+
+  // recompute the layout only after a resize or a config change
+  if (! _layout || _layout.value() != layout)
+  {
+    _layout = layout;
+    _ctx = Ctx();
+
+    _ctx.width = width;
+    _ctx.height = height;
+
+    if (cfg.view != View::date && cfg.view != View::ascii)
+    {
+      // --_ctx.height;
+
+      // set the buffer to a template
+      if (cfg.view == View::digital)
+      {
+        if (fraction() == 3)
+        {
+          set_grid<_clock_digital_milli>();
+        }
+        else if (fraction() == 2)
+        {
+          set_grid<_clock_digital_centi>();
+        }
+        else
+        {
+          cfg.seconds ? set_grid<_clock_digital_seconds>() : set_grid<_clock_digital>();
+        }
+      }
+      else if (cfg.view == View::binary)
+      {
+        cfg.seconds ? set_grid<_clock_binary_seconds>() : set_grid<_clock_binary>();
+      }
+      else
+      {
+        set_grid<_icon>();
+      }
+
+      _ctx.x_spaces = _ctx.x_blocks - 1;
+      _ctx.y_spaces = _ctx.y_blocks - 1;
+
+      calc_xy_block();
+      calc_xy_ratio();
+      calc_xy_begin();
+
+      // init block
+      _ctx.block.xy_max(_ctx.width + 1, _ctx.height + 1);
+      _ctx.block.wh(_ctx.x_block, _ctx.y_block);
+
+      // init fill
+      _ctx.fill_active = set_fill(cfg.fill_active);
+      _ctx.fill_inactive = set_fill(cfg.fill_inactive);
+      _ctx.fill_colon = set_fill(cfg.fill_colon);
+
+      // a fill cut short by a wide glyph is centred in each block,
+      // so its blocks can not be joined into a span
+      for (auto const type : {Type::off, Type::on, Type::colon})
+      {
+        auto const& fill = type == Type::on ? _ctx.fill_active :
+          type == Type::off ? _ctx.fill_inactive : _ctx.fill_colon;
+        bool const empty {(type == Type::on ? cfg.fill_active :
+          type == Type::off ? cfg.fill_inactive : cfg.fill_colon).empty()};
+
+        _ctx.spannable.at(static_cast<std::size_t>(type)) = empty ||
+          OB::Text::View(fill.substr(0, fill.find('\n'))).cols() == _ctx.x_block;
+      }
+    }
+  }
 
-  _ctx.width = width;
-  _ctx.height = height;
+  // set starting coordinates
+  _ctx.x = _ctx.x_begin;
+  _ctx.y = _ctx.y_begin;
 
   set_clock_value();
+}
 
+void Peaclock::step_style()
+{
   // cfg.style.title.step();
   cfg.style.date.step();
   cfg.style.background.step();
@@ -38,48 +120,19 @@ void Peaclock::init_ctx(std::size_t const width, std::size_t const height)
   cfg.style.active_bg.step();
   cfg.style.inactive_bg.step();
   cfg.style.colon_bg.step();
+}
 
-  if (cfg.view != View::date && cfg.view != View::ascii)
-  {
-    // --_ctx.height;
-
-    // set the buffer to a template
-    if (cfg.view == View::digital)
-    {
-      _ctx.buffer = cfg.seconds ? _clock_digital_seconds : _clock_digital;
-    }
-    else if (cfg.view == View::binary)
-    {
-      _ctx.buffer = cfg.seconds ? _clock_binary_seconds : _clock_binary;
-    }
-    else
-    {
-      _ctx.buffer = _icon;
-    }
-
-    _ctx.x_blocks = count_x_blocks(_ctx.buffer);
-    _ctx.y_blocks = count_y_blocks(_ctx.buffer);
-
-    _ctx.x_spaces = _ctx.x_blocks - 1;
-    _ctx.y_spaces = _ctx.y_blocks - 1;
-
-    calc_xy_block();
-    calc_xy_ratio();
-    calc_xy_begin();
-
-    // init block
-    _ctx.block.xy_max(_ctx.width + 1, _ctx.height + 1);
-    _ctx.block.wh(_ctx.x_block, _ctx.y_block);
+bool Peaclock::world() const
+{
+  return cfg.mode == Mode::clock && ! _zones.empty();
+}
 
-    // init fill
-    _ctx.fill_active = set_fill(cfg.fill_active);
-    _ctx.fill_inactive = set_fill(cfg.fill_inactive);
-    _ctx.fill_colon = set_fill(cfg.fill_colon);
+std::size_t Peaclock::date_lines() const
+{
+  // the date, and the zone label of the world layout
+  auto const lines = (cfg.date ? cfg.height_datefmt : 0) + (world() ? 1 : 0);
 
-    // set starting coordinates
-    _ctx.x = _ctx.x_begin;
-    _ctx.y = _ctx.y_begin;
-  }
+  return lines ? lines + cfg.date_padding.get() : 0;
 }
 
 // void Peaclock::draw_background(std::size_t const width, std::size_t const height, std::ostringstream& buf)
@@ -110,7 +163,7 @@ void Peaclock::init_ctx(std::size_t const width, std::size_t const height)
 //   }
 // }
 
-void Peaclock::draw_clock(std::ostringstream& buf)
+void Peaclock::draw_clock(OB::Framebuffer& buf)
 {
   if (cfg.view == View::date)
   {
@@ -132,9 +185,12 @@ void Peaclock::draw_clock(std::ostringstream& buf)
     }
 
     // draw blocks
-    for (std::size_t i = 0; i < _ctx.buffer.size(); ++i)
+    auto const* const cells = _ctx.buffer.data();
+    auto const size = _ctx.buffer.size();
+
+    for (std::size_t i = 0; i < size; ++i)
     {
-      auto const type = _ctx.buffer.at(i);
+      int const type {cells[i]};
 
       switch (type)
       {
@@ -146,76 +202,14 @@ void Peaclock::draw_clock(std::ostringstream& buf)
         }
 
         case Type::off:
-        {
-          _ctx.block.xy(_ctx.x, _ctx.y);
-          _ctx.block.text("");
-          _ctx.block.align(Rect::Align::center, Rect::Align::center);
-
-          _ctx.block.color_fg(cfg.style.inactive_fg);
-          _ctx.block.color_bg(
-            cfg.style.inactive_bg.mode() == OB::Color::Mode::party ||
-            cfg.style.inactive_bg.mode() == OB::Color::Mode::candy ?
-            cfg.style.inactive_bg.step() : cfg.style.inactive_bg.key() == "clear" ?
-            cfg.style.background : cfg.style.inactive_bg);
-
-          if (! cfg.fill_inactive.empty())
-          {
-            _ctx.block.text(_ctx.fill_inactive);
-          }
-
-          buf << _ctx.block;
-
-          _ctx.x += _ctx.x_block + cfg.x_space.get();
-
-          break;
-        }
-
         case Type::on:
-        {
-          _ctx.block.xy(_ctx.x, _ctx.y);
-          _ctx.block.text("");
-          _ctx.block.align(Rect::Align::center, Rect::Align::center);
-
-          _ctx.block.color_fg(cfg.style.active_fg);
-          _ctx.block.color_bg(
-            cfg.style.active_bg.mode() == OB::Color::Mode::party ||
-            cfg.style.active_bg.mode() == OB::Color::Mode::candy ?
-            cfg.style.active_bg.step() : cfg.style.active_bg.key() == "clear" ?
-            cfg.style.background : cfg.style.active_bg);
-
-          if (! cfg.fill_active.empty())
-          {
-            _ctx.block.text(_ctx.fill_active);
-          }
-
-          buf << _ctx.block;
-
-          _ctx.x += _ctx.x_block + cfg.x_space.get();
-
-          break;
-        }
-
         case Type::colon:
         {
-          _ctx.block.xy(_ctx.x, _ctx.y);
-          _ctx.block.text("");
-          _ctx.block.align(Rect::Align::center, Rect::Align::center);
-
-          _ctx.block.color_fg(cfg.style.colon_fg);
-          _ctx.block.color_bg(
-            cfg.style.colon_bg.mode() == OB::Color::Mode::party ||
-            cfg.style.colon_bg.mode() == OB::Color::Mode::candy ?
-            cfg.style.colon_bg.step() : cfg.style.colon_bg.key() == "clear" ?
-            cfg.style.active_bg : cfg.style.colon_bg);
-
-          if (! cfg.fill_colon.empty())
-          {
-            _ctx.block.text(_ctx.fill_colon);
-          }
+          // merge the following blocks of the same type into a single span
+          std::size_t const n {mergeable(type) ? count_run(cells + i, cells + size) : 1};
 
-          buf << _ctx.block;
-
-          _ctx.x += _ctx.x_block + cfg.x_space.get();
+          draw_blocks(buf, type, n);
+          i += n - 1;
 
           break;
         }
@@ -237,10 +231,159 @@ void Peaclock::draw_clock(std::ostringstream& buf)
   }
 }
 
-void Peaclock::draw_ascii(std::ostringstream& buf)
+std::size_t Peaclock::count_run(Cell const* const first, Cell const* const last)
+{
+  auto it = first;
+
+#if defined(__SSE2__)
+  // compare 16 cells at a time against the first one
+  auto const type = _mm_set1_epi8(*first);
+
+  while (last - it >= 16)
+  {
+    auto const eq = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<__m128i const*>(it)), type);
+    auto const mask = static_cast<unsigned int>(_mm_movemask_epi8(eq));
+
+    if (mask != 0xffff)
+    {
+      return static_cast<std::size_t>(it - first) + static_cast<std::size_t>(__builtin_ctz(~mask));
+    }
+
+    it += 16;
+  }
+#endif
+
+  while (it != last && *it == *first)
+  {
+    ++it;
+  }
+
+  return static_cast<std::size_t>(it - first);
+}
+
+OB::Color& Peaclock::block_bg(int const type)
+{
+  auto& bg = type == Type::on ? cfg.style.active_bg :
+    type == Type::off ? cfg.style.inactive_bg : cfg.style.colon_bg;
+
+  // party and candy colours step on every block
+  if (bg.mode() == OB::Color::Mode::party || bg.mode() == OB::Color::Mode::candy)
+  {
+    return bg.step();
+  }
+
+  if (bg.key() == "clear")
+  {
+    return type == Type::colon ? cfg.style.active_bg : cfg.style.background;
+  }
+
+  return bg;
+}
+
+bool Peaclock::mergeable(int const type)
+{
+  auto const& bg = type == Type::on ? cfg.style.active_bg :
+    type == Type::off ? cfg.style.inactive_bg : cfg.style.colon_bg;
+
+  // every block of a party or candy colour gets its own colour
+  if (bg.mode() == OB::Color::Mode::party || bg.mode() == OB::Color::Mode::candy ||
+    ! _ctx.spannable.at(static_cast<std::size_t>(type)))
+  {
+    return false;
+  }
+
+  if (cfg.x_space.get() == 0)
+  {
+    return true;
+  }
+
+  // the gaps between blocks show the background,
+  // covering them is only invisible when the blocks look the same
+  auto const& fill = type == Type::on ? cfg.fill_active :
+    type == Type::off ? cfg.fill_inactive : cfg.fill_colon;
+
+  // a foreground colour does not show on a blank, attributes such as
+  // reverse do, so the fg must be clear or a colour, SGR 30 to 39 or 90 to 97
+  auto const& fg = (type == Type::on ? cfg.style.active_fg :
+    type == Type::off ? cfg.style.inactive_fg : cfg.style.colon_fg).value();
+
+  if (! fg.empty())
+  {
+    // skip the CSI
+    int param {0};
+    auto const res = std::from_chars(fg.data() + std::min<std::size_t>(2, fg.size()),
+      fg.data() + fg.size(), param);
+
+    if (res.ec != std::errc() || ! ((param >= 30 && param <= 39) || (param >= 90 && param <= 97)))
+    {
+      return false;
+    }
+  }
+
+  return fill.find_first_not_of(' ') == std::string::npos &&
+    block_bg(type).value() == cfg.style.background.value();
+}
+
+void Peaclock::draw_blocks(OB::Framebuffer& buf, int const type, std::size_t const n)
+{
+  auto const& fill = type == Type::on ? _ctx.fill_active :
+    type == Type::off ? _ctx.fill_inactive : _ctx.fill_colon;
+  bool const empty {(type == Type::on ? cfg.fill_active :
+    type == Type::off ? cfg.fill_inactive : cfg.fill_colon).empty()};
+
+  _ctx.block.xy(_ctx.x, _ctx.y);
+  _ctx.block.wh((_ctx.x_block * n) + (cfg.x_space.get() * (n - 1)), _ctx.y_block);
+  _ctx.block.text("");
+  _ctx.block.align(Rect::Align::center, Rect::Align::center);
+
+  _ctx.block.color_fg(type == Type::on ? cfg.style.active_fg :
+    type == Type::off ? cfg.style.inactive_fg : cfg.style.colon_fg);
+  _ctx.block.color_bg(block_bg(type));
+
+  if (! empty)
+  {
+    if (n == 1)
+    {
+      _ctx.block.text(fill);
+    }
+    else
+    {
+      // each line of the span repeats the block line, separated by the gaps
+      auto& span = _ctx.span[static_cast<std::size_t>(type)][n];
+
+      if (span.empty())
+      {
+        std::string const gap (cfg.x_space.get(), ' ');
+
+        for (auto const& line : OB::String::split(fill, "\n"))
+        {
+          if (line.empty())
+          {
+            continue;
+          }
+
+          for (std::size_t j = 0; j < n; ++j)
+          {
+            span += (j ? gap : "") + line;
+          }
+
+          span += "\n";
+        }
+      }
+
+      _ctx.block.text(span);
+    }
+  }
+
+  buf << _ctx.block;
+
+  _ctx.x += (_ctx.x_block + cfg.x_space.get()) * n;
+}
+
+void Peaclock::draw_ascii(OB::Framebuffer& buf)
 {
   std::size_t const y = ([&]() {
-    return (_ctx.height / 2) - ((1 + (cfg.date && cfg.height_datefmt ? cfg.height_datefmt + cfg.date_padding.get() : 0)) / 2);
+    return (_ctx.height / 2) - ((1 + date_lines()) / 2);
   })();
   _ctx.y += y;
 
@@ -249,17 +392,32 @@ void Peaclock::draw_ascii(std::ostringstream& buf)
   _ctx.text.wh(_ctx.width, 1);
   _ctx.text.color_fg(cfg.style.active_fg);
   _ctx.text.color_bg(cfg.style.background);
-  _ctx.text.text(std::to_string(_ctx.value.at(0)) + std::to_string(_ctx.value.at(1)) + ":" + std::to_string(_ctx.value.at(2)) + std::to_string(_ctx.value.at(3)) +
-    (cfg.seconds ? ":" + std::to_string(_ctx.value.at(4)) + std::to_string(_ctx.value.at(5)) : ""));
+
+  std::string str {std::to_string(_ctx.value.at(0)) + std::to_string(_ctx.value.at(1)) + ":" + std::to_string(_ctx.value.at(2)) + std::to_string(_ctx.value.at(3)) +
+    (cfg.seconds || fraction() ? ":" + std::to_string(_ctx.value.at(4)) + std::to_string(_ctx.value.at(5)) : "")};
+
+  if (auto const digits = fraction())
+  {
+    str += ".";
+
+    for (std::size_t i = 0; i < digits; ++i)
+    {
+      str += static_cast<char>('0' + _ctx.value.at(Position::f1 + i));
+    }
+  }
+
+  _ctx.text.text(str);
   _ctx.text.align(Rect::Align::center, Rect::Align::center);
   _ctx.text.highlight({{":", cfg.style.colon_fg}});
 
   buf << _ctx.text;
 }
 
-void Peaclock::draw_date(std::ostringstream& buf)
+void Peaclock::draw_date(OB::Framebuffer& buf)
 {
-  if (cfg.date && cfg.datefmt.size())
+  bool const date {cfg.date && cfg.datefmt.size()};
+
+  if (date || _zone)
   {
     std::size_t const y = ([&]() {
       if (cfg.view == View::date)
@@ -277,10 +435,20 @@ void Peaclock::draw_date(std::ostringstream& buf)
 
     _ctx.text.xy_max(_ctx.width + 1, _ctx.height + 1);
     _ctx.text.xy(0, y);
-    _ctx.text.wh(_ctx.width, cfg.height_datefmt);
+    _ctx.text.wh(_ctx.width, (date ? cfg.height_datefmt : 0) + (_zone ? 1 : 0));
     _ctx.text.color_fg(cfg.style.date);
     _ctx.text.color_bg(cfg.style.background);
-    _ctx.text.text(_ctx.datefmt);
+
+    if (! _zone)
+    {
+      _ctx.text.text(_ctx.datefmt);
+    }
+    else
+    {
+      // the zone label goes below the date
+      _ctx.text.text(date ? _ctx.datefmt + "\n" + _zone->label : _zone->label);
+    }
+
     _ctx.text.align(Rect::Align::center, Rect::Align::top);
     _ctx.text.highlight({{":", cfg.style.colon_fg}});
 
@@ -288,69 +456,184 @@ void Peaclock::draw_date(std::ostringstream& buf)
   }
 }
 
-void Peaclock::render(std::size_t const width, std::size_t const height, std::ostringstream& buf)
+void Peaclock::draw_world(std::size_t const width, std::size_t const height, OB::Framebuffer& buf)
 {
-  init_ctx(width, height);
+  auto const [cols, rows] = world_grid(width, height);
+  auto const w = width / cols;
+  auto const h = height / rows;
 
-  // draw_background(width, height, buf);
-  // draw_title(buf);
-  draw_clock(buf);
-  draw_date(buf);
-}
+  if (w == 0 || h == 0)
+  {
+    return;
+  }
 
-std::size_t Peaclock::find(Peaclock::Clock const& vec, int const val, std::size_t const pos) const
-{
-  auto const res = std::find(vec.begin() + static_cast<long int>(pos), vec.end(), val);
+  // every cell has the same size, so the layout, fills and spans
+  // are computed once and shared by all of the clocks
+  for (std::size_t i = 0; i < _zones.size(); ++i)
+  {
+    auto const row = i / cols;
+    auto const col = i % cols;
+
+    // centre the grid, and the cells of a partial last row
+    auto const n = std::min(cols, _zones.size() - (row * cols));
+    auto const x = ((width - (w * n)) / 2) + (col * w);
+    auto const y = ((height - (h * rows)) / 2) + (row * h);
 
-  return res != vec.end() ? static_cast<std::size_t>(std::distance(vec.begin(), res)) : npos;
+    _zone = &_zones.at(i);
+    buf.viewport(x, y, w, h);
+
+    init_ctx(w, h);
+    draw_clock(buf);
+    draw_date(buf);
+  }
+
+  _zone = nullptr;
+  buf.viewport();
 }
 
-std::size_t Peaclock::count(Clock const& vec, int const val) const
+std::pair<std::size_t, std::size_t> Peaclock::world_grid(std::size_t const width, std::size_t const height) const
 {
-  std::size_t pos {0};
-  std::size_t count {0};
+  // size of a clock with blocks of one cell, in columns and lines
+  std::size_t x_blocks {cfg.seconds ? 8ul : 5ul};
+  std::size_t y_blocks {1};
 
-  for (;;)
+  switch (cfg.view)
   {
-    pos = find(vec, val, pos);
+    case View::digital:
+    {
+      x_blocks = cfg.seconds ? count_x_blocks(_clock_digital_seconds) : count_x_blocks(_clock_digital);
+      y_blocks = count_y_blocks(_clock_digital);
 
-    if (pos == npos)
+      break;
+    }
+
+    case View::binary:
+    {
+      x_blocks = cfg.seconds ? count_x_blocks(_clock_binary_seconds) : count_x_blocks(_clock_binary);
+      y_blocks = count_y_blocks(_clock_binary);
+
+      break;
+    }
+
+    case View::icon:
+    {
+      x_blocks = count_x_blocks(_icon);
+      y_blocks = count_y_blocks(_icon);
+
+      break;
+    }
+
+    default:
     {
       break;
     }
+  }
+
+  bool const blocks {cfg.view != View::date && cfg.view != View::ascii};
+  double const clock_w {blocks ? static_cast<double>((x_blocks * cfg.x_ratio.get()) +
+    ((x_blocks - 1) * cfg.x_space.get()) + (cfg.x_border.get() * 2)) : static_cast<double>(x_blocks)};
+  double const clock_h {static_cast<double>((blocks ? (y_blocks * cfg.y_ratio.get()) +
+    ((y_blocks - 1) * cfg.y_space.get()) + (cfg.y_border.get() * 2) :
+    (cfg.view == View::ascii ? 1 : 0)) + date_lines())};
+
+  // pick the number of columns that gives each clock the largest scale
+  std::size_t cols {1};
+  double scale {-1};
+
+  for (std::size_t c = 1; c <= _zones.size(); ++c)
+  {
+    auto const r = (_zones.size() + c - 1) / c;
+    auto const val = std::min((width / c) / clock_w, (height / r) / clock_h);
 
-    ++count;
-    ++pos;
+    if (val > scale)
+    {
+      scale = val;
+      cols = c;
+    }
   }
 
-  return count;
+  return {cols, (_zones.size() + cols - 1) / cols};
 }
 
-std::size_t Peaclock::count_x_blocks(Clock const& clock) const
+void Peaclock::render(std::size_t const width, std::size_t const height, OB::Framebuffer& buf)
 {
-  auto pos = find(clock, 2);
+  step_style();
 
-  if (pos == npos)
+  if (world())
   {
-    pos = clock.size();
+    draw_world(width, height, buf);
+
+    return;
   }
 
-  std::size_t count {0};
+  init_ctx(width, height);
+
+  // draw_background(width, height, buf);
+  // draw_title(buf);
+  draw_clock(buf);
+  draw_date(buf);
+}
+
+std::chrono::nanoseconds Peaclock::next_change() const
+{
+  using namespace std::chrono;
+
+  auto const now = system_clock::now();
 
-  for (std::size_t i = 0; i < pos; ++i)
+  // check if the date format displays seconds
+  bool const date_seconds {cfg.date && _datefmt.has(&std::tm::tm_sec)};
+
+  // the clock and date follow the wall clock, on the next second or minute
+  bool const clock_seconds {cfg.mode == Mode::clock && cfg.seconds && cfg.view != View::date};
+
+  nanoseconds next {date_seconds || clock_seconds ?
+    floor<seconds>(now) + seconds(1) - now :
+    floor<minutes>(now) + minutes(1) - now};
+
+  // a running timer or stopwatch changes on each of its own seconds,
+  // measured on the monotonic clock
+  for (auto const* e : {&timer, &stopwatch})
   {
-    if (clock.at(i) == -1 || clock.at(i) == 0 || clock.at(i) == 1)
+    if (*e)
     {
-      ++count;
+      next = std::min(next, ceil<nanoseconds>(e->next()));
     }
   }
 
-  return count;
+  // a stopwatch showing fractions changes on each of its shown steps
+  if (auto const digits = fraction(); digits && stopwatch)
+  {
+    next = std::min(next, ceil<nanoseconds>(stopwatch.next(digits == 3 ?
+      milliseconds(1) : milliseconds(10))));
+  }
+
+  return next;
 }
 
-std::size_t Peaclock::count_y_blocks(Clock const& clock) const
+std::size_t Peaclock::fraction() const
 {
-  return count(clock, 2);
+  if (cfg.mode != Mode::stopwatch || (cfg.view != View::digital && cfg.view != View::ascii))
+  {
+    return 0;
+  }
+
+  return cfg.precision == Precision::millisecond ? 3 :
+    cfg.precision == Precision::centisecond ? 2 : 0;
+}
+
+bool Peaclock::animated() const
+{
+  for (auto const* e : {&cfg.style.active_fg, &cfg.style.inactive_fg,
+    &cfg.style.active_bg, &cfg.style.inactive_bg, &cfg.style.colon_fg,
+    &cfg.style.colon_bg, &cfg.style.date, &cfg.style.background})
+  {
+    if (e->mode() != OB::Color::Mode::null)
+    {
+      return true;
+    }
+  }
+
+  return false;
 }
 
 void Peaclock::extract_digits(int const num, int& t0, int& t1) const
@@ -395,7 +678,7 @@ void Peaclock::calc_xy_block()
 
   if (auto const val = (_ctx.height - (cfg.y_space.get() * _ctx.y_spaces) - (cfg.y_border.get() * 2) -
     // (cfg.title && cfg.height_titlefmt ? cfg.height_titlefmt + 1 : 0) -
-    (cfg.date && cfg.height_datefmt ? cfg.height_datefmt + cfg.date_padding.get() : 0)) / _ctx.y_blocks;
+    date_lines()) / _ctx.y_blocks;
     static_cast<int>(val) > 0)
   {
     _ctx.y_block = val;
@@ -492,7 +775,7 @@ void Peaclock::calc_xy_begin()
 
   if (auto const val = ((_ctx.y_block * _ctx.y_blocks) + (cfg.y_space.get() * _ctx.y_spaces) +
     // (cfg.title && cfg.height_titlefmt ? cfg.height_titlefmt + 1 : 0) +
-    (cfg.date && cfg.height_datefmt ? cfg.height_datefmt + cfg.date_padding.get() : 0)) / 2;
+    date_lines()) / 2;
     val < _ctx.height / 2)
   {
     _ctx.y_begin = (_ctx.height / 2) - val;
@@ -505,39 +788,29 @@ void Peaclock::calc_xy_begin()
 
 void Peaclock::fill_digital(std::size_t width, std::size_t begin, std::size_t end, Position::Type type)
 {
-  for (std::size_t i = 0, j = 0; i < 5; ++i)
+  auto const bits = _symbol[static_cast<std::size_t>(_ctx.value[type])];
+
+  for (std::size_t i = 0, j = 14; i < 5; ++i)
   {
-    for (std::size_t k = begin; k < end; ++j, ++k)
+    for (std::size_t k = begin; k < end; --j, ++k)
     {
-      _ctx.buffer.at(k + (width * i)) = _symbol.at(static_cast<std::size_t>(_ctx.value.at(type))).at(j);
+      _ctx.buffer[k + (width * i)] = static_cast<Cell>((bits >> j) & 1);
     }
   }
 }
 
 void Peaclock::fill_binary(std::size_t width, std::size_t col, int num)
 {
-  if (num >= 8)
-  {
-    num -= 8;
-    _ctx.buffer.at(col + (0 * width)) = 1;
-  }
-
-  if (num >= 4)
-  {
-    num -= 4;
-    _ctx.buffer.at(col + (1 * width)) = 1;
-  }
-
-  if (num >= 2)
+  // write every bit, the buffer is reused between frames,
+  // leaving the empty cells of the template untouched
+  for (std::size_t row = 0, bit = 3; row < 4; ++row, --bit)
   {
-    num -= 2;
-    _ctx.buffer.at(col + (2 * width)) = 1;
-  }
+    auto& cell = _ctx.buffer[col + (row * width)];
 
-  if (num == 1)
-  {
-    --num;
-    _ctx.buffer.at(col + (3 * width)) = 1;
+    if (cell != Type::empty)
+    {
+      cell = static_cast<Cell>((num >> bit) & 1);
+    }
   }
 }
 
@@ -550,16 +823,35 @@ void Peaclock::fill_binary(std::size_t width, std::size_t col, int num)
 void Peaclock::cfg_datefmt(std::string const& str)
 {
   cfg.datefmt = str;
+  _datefmt.fmt(cfg.datefmt);
+
+  for (auto& e : _zones)
+  {
+    e.datefmt.fmt(cfg.datefmt);
+  }
   cfg.height_datefmt = OB::String::count(cfg.datefmt, "\n") + (cfg.datefmt.size() ? 1 : 0);
 }
 
-bool Peaclock::cfg_timezone(std::string const& tz)
+std::optional<OB::Timezone> Peaclock::load_timezone(std::string const& tz)
+{
+  OB::Timezone zone;
+
+  // the system zone falls back to UTC
+  if (! zone.load(tz) && ! tz.empty())
+  {
+    return {};
+  }
+
+  return zone;
+}
+
+void Peaclock::cfg_timezone(std::string const& tz, OB::Timezone zone)
 {
   cfg.timezone = tz;
+  _tz = std::move(zone);
 
-  return cfg.timezone.empty() ?
-    unsetenv("TZ") == 0 :
-    setenv("TZ", cfg.timezone.data(), 1) == 0;
+  // the zone name and offset are not part of the cached date
+  _datefmt.reset();
 }
 
 bool Peaclock::cfg_locale(std::string const& lc)
@@ -572,18 +864,62 @@ bool Peaclock::cfg_locale(std::string const& lc)
   catch (...)
   {
     cfg.locale.clear();
+  }
 
-    return false;
+  _datefmt.locale(cfg.locale);
+
+  for (auto& e : _zones)
+  {
+    e.datefmt.locale(cfg.locale);
+  }
+
+  return cfg.locale == lc;
+}
+
+std::optional<std::vector<OB::Timezone>> Peaclock::load_zones(std::string const& str)
+{
+  std::vector<OB::Timezone> zones;
+
+  for (auto const& name : OB::String::split(str, " "))
+  {
+    if (name.empty())
+    {
+      continue;
+    }
+
+    if (! zones.emplace_back().load(name))
+    {
+      return {};
+    }
   }
 
-  return true;
+  return zones;
+}
+
+void Peaclock::cfg_zones(std::string const& str, std::vector<OB::Timezone> zones)
+{
+  cfg.zones = str;
+  _zones.clear();
+  _zone = nullptr;
+
+  for (auto& tz : zones)
+  {
+    Zone zone;
+
+    // label a zone by its last part, 'America/New_York' as 'New York'
+    zone.label = tz.name().substr(tz.name().rfind('/') + 1);
+    std::replace(zone.label.begin(), zone.label.end(), '_', ' ');
+
+    zone.tz = std::move(tz);
+    zone.datefmt.fmt(cfg.datefmt).locale(cfg.locale);
+    _zones.emplace_back(std::move(zone));
+  }
 }
 
 void Peaclock::set_clock_value()
 {
   // get the current time
-  std::time_t time_raw {std::time(nullptr)};
-  std::tm time_now {*std::localtime(&time_raw)};
+  std::tm const time_now {(_zone ? _zone->tz : _tz).local(std::time(nullptr))};
 
   int hour {0};
   int min {0};
@@ -602,7 +938,13 @@ void Peaclock::set_clock_value()
 
   if (cfg.mode == Mode::stopwatch)
   {
-    std::tie(hour, min, sec) = stopwatch.hms();
+    int msec {0};
+    std::tie(hour, min, sec, msec) = stopwatch.hms_ms();
+
+    // fractions of a second, most significant digit first
+    _ctx.value.at(Position::f1) = msec / 100;
+    _ctx.value.at(Position::f2) = (msec / 10) % 10;
+    _ctx.value.at(Position::f3) = msec % 10;
   }
 
   else if (cfg.mode == Mode::clock)
@@ -642,45 +984,44 @@ void Peaclock::set_clock_value()
 
 void Peaclock::set_date(std::tm const& time_now)
 {
-  std::ostringstream os;
-  os.imbue(std::locale(cfg.locale));
-  os << std::put_time(&time_now, cfg.datefmt.c_str());
-
-  _ctx.datefmt = os.str();
+  _ctx.datefmt = (_zone ? _zone->datefmt : _datefmt).str(time_now);
 }
 
 void Peaclock::set_clock_digital()
 {
-  std::size_t const row_len {cfg.seconds ? 28ul : 18ul};
+  auto const row_len = _ctx.stride;
 
   fill_digital(row_len, 0, 3, Position::H);
   fill_digital(row_len, 4, 7, Position::h);
   fill_digital(row_len, 10, 13, Position::M);
-  fill_digital(row_len, 10, 13, Position::M);
   fill_digital(row_len, 14, 17, Position::m);
 
-  if (cfg.seconds)
+  if (cfg.seconds || fraction())
   {
     fill_digital(row_len, 20, 23, Position::S);
     fill_digital(row_len, 24, 27, Position::s);
   }
+
+  if (auto const digits = fraction())
+  {
+    fill_digital(row_len, 30, 33, Position::f1);
+    fill_digital(row_len, 34, 37, Position::f2);
+
+    if (digits == 3)
+    {
+      fill_digital(row_len, 38, 41, Position::f3);
+    }
+  }
 }
 
 void Peaclock::set_clock_binary()
 {
-  std::size_t const row_len {cfg.seconds ? 6ul : 4ul};
+  auto const row_len = _ctx.stride;
 
-  if (cfg.hour_24)
-  {
-    _ctx.buffer.at(0 + (2 * (row_len + 1))) = 0;
-  }
-  else
-  {
-    _ctx.buffer.at(0 + (2 * (row_len + 1))) = -1;
-  }
+  _ctx.buffer[2 * row_len] = cfg.hour_24 ? Type::off : Type::empty;
 
-  for (std::size_t col {0}; col < row_len; ++col)
+  for (std::size_t col {0}; col + 1 < row_len; ++col)
   {
-    fill_binary(row_len + 1, col, _ctx.value.at(col));
+    fill_binary(row_len, col, _ctx.value[col]);
   }
 }
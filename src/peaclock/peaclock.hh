@@ -5,24 +5,44 @@
 #include "ob/rect.hh"
 using Rect = OB::Rect;
 
+#include "ob/framebuffer.hh"
+
 #include "ob/num.hh"
 #include "ob/color.hh"
 #include "ob/timer.hh"
+#include "ob/datefmt.hh"
+#include "ob/timezone.hh"
 #include "ob/term.hh"
 namespace aec = OB::Term::ANSI_Escape_Codes;
 
 #include <ctime>
 #include <cstddef>
+#include <cstdint>
 
 #include <string>
+#include <array>
+#include <algorithm>
+#include <unordered_map>
 #include <sstream>
 #include <vector>
+#include <chrono>
+#include <optional>
+#include <utility>
 
 class Peaclock
 {
 public:
 
-  void render(std::size_t const width, std::size_t const height, std::ostringstream& buf);
+  void render(std::size_t const width, std::size_t const height, OB::Framebuffer& buf);
+
+  // time until the next change to the displayed value
+  std::chrono::nanoseconds next_change() const;
+
+  // true when a colour changes on every frame
+  bool animated() const;
+
+  // digits shown after the seconds of a stopwatch, 0 when none
+  std::size_t fraction() const;
 
   struct Mode
   {
@@ -180,6 +200,68 @@ public:
     }
   };
 
+  struct Precision
+  {
+    enum Type
+    {
+      second = 0,
+      centisecond,
+      millisecond,
+    };
+
+    static Type enm(std::string const& type)
+    {
+      if (type.empty())
+      {
+        return second;
+      }
+
+      switch (type.at(0))
+      {
+        case 'c':
+        {
+          return centisecond;
+        }
+
+        case 'm':
+        {
+          return millisecond;
+        }
+
+        default:
+        {
+          return second;
+        }
+      }
+    }
+
+    static std::string str(Type type)
+    {
+      switch (type)
+      {
+        case second:
+        {
+          return "second";
+        }
+
+        case centisecond:
+        {
+          return "centisecond";
+        }
+
+        case millisecond:
+        {
+          return "millisecond";
+        }
+
+        default:
+        {
+          return {};
+        }
+      }
+    }
+  };
+
   struct Toggle
   {
     enum Type
@@ -350,6 +432,7 @@ public:
   {
     Mode::Type mode {Mode::clock};
     View::Type view {View::digital};
+    Precision::Type precision {Precision::second};
     Toggle::Type toggle {Toggle::active_bg};
 
     bool timer_notify {false};
@@ -382,6 +465,7 @@ public:
 
     std::string locale {""};
     std::string timezone {""};
+    std::string zones {""};
     // std::string titlefmt {""};
     std::string datefmt {"%a %b %d"};
     std::string fill_active {""};
@@ -408,7 +492,14 @@ public:
   // void cfg_titlefmt(std::string const& str);
   void cfg_datefmt(std::string const& str);
   bool cfg_locale(std::string const& lc);
-  bool cfg_timezone(std::string const& tz);
+
+  // zones are loaded while a command is parsed, so that applying it cannot fail,
+  // an empty name is the system zone, nothing is returned for an unknown zone
+  static std::optional<OB::Timezone> load_timezone(std::string const& tz);
+  static std::optional<std::vector<OB::Timezone>> load_zones(std::string const& str);
+
+  void cfg_timezone(std::string const& tz, OB::Timezone zone);
+  void cfg_zones(std::string const& str, std::vector<OB::Timezone> zones);
 
   OB::Timer timer;
   OB::Timer stopwatch;
@@ -425,6 +516,9 @@ private:
       m,
       S,
       s,
+      f1,
+      f2,
+      f3,
     };
   };
 
@@ -440,24 +534,27 @@ private:
     };
   };
 
-  using Clock = std::vector<int>;
+  // one byte per cell, rows follow each other closed by a newline cell
+  using Cell = std::int8_t;
+  using Clock = std::vector<Cell>;
 
-  std::vector<Clock> const _symbol
+  // 3 x 5 digit bitmaps, one bit per cell,
+  // rows top to bottom from the most significant bit
+  static constexpr std::array<std::uint16_t, 10> _symbol
   {
-    // 3 x 5
-    {1, 1, 1, 1, 0, 1, 1, 0, 1, 1, 0, 1, 1, 1, 1}, // 0
-    {0, 1, 0, 0, 1, 0, 0, 1, 0, 0, 1, 0, 0, 1, 0}, // 1
-    {1, 1, 1, 0, 0, 1, 1, 1, 1, 1, 0, 0, 1, 1, 1}, // 2
-    {1, 1, 1, 0, 0, 1, 1, 1, 1, 0, 0, 1, 1, 1, 1}, // 3
-    {1, 0, 1, 1, 0, 1, 1, 1, 1, 0, 0, 1, 0, 0, 1}, // 4
-    {1, 1, 1, 1, 0, 0, 1, 1, 1, 0, 0, 1, 1, 1, 1}, // 5
-    {1, 1, 1, 1, 0, 0, 1, 1, 1, 1, 0, 1, 1, 1, 1}, // 6
-    {1, 1, 1, 0, 0, 1, 0, 0, 1, 0, 0, 1, 0, 0, 1}, // 7
-    {1, 1, 1, 1, 0, 1, 1, 1, 1, 1, 0, 1, 1, 1, 1}, // 8
-    {1, 1, 1, 1, 0, 1, 1, 1, 1, 0, 0, 1, 0, 0, 1}, // 9
+    0b111'101'101'101'111, // 0
+    0b010'010'010'010'010, // 1
+    0b111'001'111'100'111, // 2
+    0b111'001'111'001'111, // 3
+    0b101'101'111'001'001, // 4
+    0b111'100'111'001'111, // 5
+    0b111'100'111'101'111, // 6
+    0b111'001'001'001'001, // 7
+    0b111'101'111'101'111, // 8
+    0b111'101'111'001'001, // 9
   };
 
-  Clock const _icon
+  static constexpr std::array _icon
   {
     0,0,0,0,0,0,0,0,0,0,0,0,1,1,1,1,1,1,1,1,0,0,0,0,0,0,0,0,0,0,0,0,2,
     0,0,0,0,0,0,0,0,0,0,1,1,1,1,1,1,1,1,1,1,1,1,0,0,0,0,0,0,0,0,0,0,2,
@@ -479,7 +576,7 @@ private:
     0,0,0,0,0,0,0,0,0,0,0,1,1,1,0,0,0,0,1,1,1,0,0,0,0,0,0,0,0,0,0,0,2,
   };
 
-  Clock const _clock_digital
+  static constexpr std::array _clock_digital
   {
     0, 0, 0,  0,  0, 0, 0,  0, 0, 0,  0, 0, 0,  0,  0, 0, 0,  2,
     0, 0, 0,  0,  0, 0, 0,  0, 3, 0,  0, 0, 0,  0,  0, 0, 0,  2,
@@ -489,7 +586,7 @@ private:
   //      H   sp        h         :         M   sp        m   nl
   };
 
-  Clock const _clock_digital_seconds
+  static constexpr std::array _clock_digital_seconds
   {
     0, 0, 0,  0,  0, 0, 0,  0, 0, 0,  0, 0, 0,  0,  0, 0, 0,  0, 0, 0,  0, 0, 0,  0,  0, 0, 0,  2,
     0, 0, 0,  0,  0, 0, 0,  0, 3, 0,  0, 0, 0,  0,  0, 0, 0,  0, 3, 0,  0, 0, 0,  0,  0, 0, 0,  2,
@@ -499,7 +596,27 @@ private:
   //      H   sp        h         :         M   sp        m         :         S   sp        s   nl
   };
 
-  Clock const _clock_binary
+  static constexpr std::array _clock_digital_centi
+  {
+    0, 0, 0,  0,  0, 0, 0,  0, 0, 0,  0, 0, 0,  0,  0, 0, 0,  0, 0, 0,  0, 0, 0,  0,  0, 0, 0,  0, 0, 0,  0, 0, 0,  0,  0, 0, 0,  2,
+    0, 0, 0,  0,  0, 0, 0,  0, 3, 0,  0, 0, 0,  0,  0, 0, 0,  0, 3, 0,  0, 0, 0,  0,  0, 0, 0,  0, 0, 0,  0, 0, 0,  0,  0, 0, 0,  2,
+    0, 0, 0,  0,  0, 0, 0,  0, 0, 0,  0, 0, 0,  0,  0, 0, 0,  0, 0, 0,  0, 0, 0,  0,  0, 0, 0,  0, 0, 0,  0, 0, 0,  0,  0, 0, 0,  2,
+    0, 0, 0,  0,  0, 0, 0,  0, 3, 0,  0, 0, 0,  0,  0, 0, 0,  0, 3, 0,  0, 0, 0,  0,  0, 0, 0,  0, 0, 0,  0, 0, 0,  0,  0, 0, 0,  2,
+    0, 0, 0,  0,  0, 0, 0,  0, 0, 0,  0, 0, 0,  0,  0, 0, 0,  0, 0, 0,  0, 0, 0,  0,  0, 0, 0,  0, 3, 0,  0, 0, 0,  0,  0, 0, 0,  2,
+  //      H   sp        h         :         M   sp        m         :         S   sp        s         .         f   sp        f   nl
+  };
+
+  static constexpr std::array _clock_digital_milli
+  {
+    0, 0, 0,  0,  0, 0, 0,  0, 0, 0,  0, 0, 0,  0,  0, 0, 0,  0, 0, 0,  0, 0, 0,  0,  0, 0, 0,  0, 0, 0,  0, 0, 0,  0,  0, 0, 0,  0,  0, 0, 0,  2,
+    0, 0, 0,  0,  0, 0, 0,  0, 3, 0,  0, 0, 0,  0,  0, 0, 0,  0, 3, 0,  0, 0, 0,  0,  0, 0, 0,  0, 0, 0,  0, 0, 0,  0,  0, 0, 0,  0,  0, 0, 0,  2,
+    0, 0, 0,  0,  0, 0, 0,  0, 0, 0,  0, 0, 0,  0,  0, 0, 0,  0, 0, 0,  0, 0, 0,  0,  0, 0, 0,  0, 0, 0,  0, 0, 0,  0,  0, 0, 0,  0,  0, 0, 0,  2,
+    0, 0, 0,  0,  0, 0, 0,  0, 3, 0,  0, 0, 0,  0,  0, 0, 0,  0, 3, 0,  0, 0, 0,  0,  0, 0, 0,  0, 0, 0,  0, 0, 0,  0,  0, 0, 0,  0,  0, 0, 0,  2,
+    0, 0, 0,  0,  0, 0, 0,  0, 0, 0,  0, 0, 0,  0,  0, 0, 0,  0, 0, 0,  0, 0, 0,  0,  0, 0, 0,  0, 3, 0,  0, 0, 0,  0,  0, 0, 0,  0,  0, 0, 0,  2,
+  //      H   sp        h         :         M   sp        m         :         S   sp        s         .         f   sp        f   sp        f   nl
+  };
+
+  static constexpr std::array _clock_binary
   {
     -1, 0, -1, 0,  2,
     -1, 0,  0, 0,  2,
@@ -508,7 +625,7 @@ private:
   // H  h   M  m   nl
   };
 
-  Clock const _clock_binary_seconds
+  static constexpr std::array _clock_binary_seconds
   {
     -1, 0, -1, 0, -1, 0,  2,
     -1, 0,  0, 0,  0, 0,  2,
@@ -517,16 +634,90 @@ private:
   // H  h   M  m   S  s   nl
   };
 
+  // inputs that determine the clock layout
+  struct Layout
+  {
+    std::size_t width {0};
+    std::size_t height {0};
+
+    View::Type view {View::digital};
+    bool seconds {false};
+    std::size_t fraction {0};
+    bool date {true};
+    bool auto_size {true};
+    bool auto_ratio {true};
+
+    std::size_t x_block {0};
+    std::size_t y_block {0};
+    std::size_t x_ratio {0};
+    std::size_t y_ratio {0};
+    std::size_t x_border {0};
+    std::size_t y_border {0};
+    std::size_t x_space {0};
+    std::size_t y_space {0};
+    std::size_t date_padding {0};
+    std::size_t date_lines {0};
+
+    std::string fill_active;
+    std::string fill_inactive;
+    std::string fill_colon;
+
+    bool operator==(Layout const& rhs) const
+    {
+      return width == rhs.width && height == rhs.height &&
+        view == rhs.view && seconds == rhs.seconds && fraction == rhs.fraction && date == rhs.date &&
+        auto_size == rhs.auto_size && auto_ratio == rhs.auto_ratio &&
+        x_block == rhs.x_block && y_block == rhs.y_block &&
+        x_ratio == rhs.x_ratio && y_ratio == rhs.y_ratio &&
+        x_border == rhs.x_border && y_border == rhs.y_border &&
+        x_space == rhs.x_space && y_space == rhs.y_space &&
+        date_padding == rhs.date_padding && date_lines == rhs.date_lines &&
+        fill_active == rhs.fill_active && fill_inactive == rhs.fill_inactive &&
+        fill_colon == rhs.fill_colon;
+    }
+
+    bool operator!=(Layout const& rhs) const
+    {
+      return ! (*this == rhs);
+    }
+  };
+
+  // layout the current context was computed for
+  std::optional<Layout> _layout;
+
+  // formatter of the date line, rebuilt only when its fields change
+  OB::Datefmt _datefmt {cfg.datefmt};
+
+  // zone of the clock and date, the system zone until a timezone command
+  OB::Timezone _tz {cfg.timezone};
+
+  // a clock of the world layout
+  struct Zone
+  {
+    std::string label;
+    OB::Timezone tz;
+    OB::Datefmt datefmt;
+  };
+
+  // zones of the world layout, drawn side by side in clock mode
+  std::vector<Zone> _zones;
+
+  // zone being drawn, null outside of the world layout
+  Zone* _zone {nullptr};
+
   struct Ctx
   {
-    Clock value
+    std::array<int, 9> value
     {
-       0, 0, 0, 0, 0, 0
-    // H  h  M  m  S  s
+       0, 0, 0, 0, 0, 0, 0,  0,  0
+    // H  h  M  m  S  s  f1  f2  f3
     };
 
     Clock buffer;
 
+    // cells per row of the buffer, including the newline
+    std::size_t stride {0};
+
     Rect text;
     Rect block;
     // Rect background;
@@ -535,6 +726,12 @@ private:
     std::string fill_inactive;
     std::string fill_colon;
 
+    // fill of merged runs of blocks, by block type then by run length
+    std::array<std::unordered_map<std::size_t, std::string>, 4> span;
+
+    // whether the blocks of a type can be merged, by block type
+    std::array<bool, 4> spannable {};
+
     std::string datefmt;
 
     std::size_t x {0};
@@ -558,14 +755,83 @@ private:
 
   std::size_t const npos {std::numeric_limits<std::size_t>::max()};
 
-  std::size_t find(Clock const& vec, int const val, std::size_t const pos = 0) const;
-  std::size_t count(Clock const& vec, int const val) const;
-  std::size_t count_x_blocks(Clock const& clock) const;
-  std::size_t count_y_blocks(Clock const& clock) const;
+  // blocks in the first row of a template
+  template<std::size_t N>
+  static constexpr std::size_t count_x_blocks(std::array<int, N> const& grid)
+  {
+    std::size_t count {0};
+
+    for (std::size_t i = 0; i < N && grid[i] != Type::newline; ++i)
+    {
+      if (grid[i] == Type::empty || grid[i] == Type::off || grid[i] == Type::on)
+      {
+        ++count;
+      }
+    }
+
+    return count;
+  }
+
+  // rows of a template
+  template<std::size_t N>
+  static constexpr std::size_t count_y_blocks(std::array<int, N> const& grid)
+  {
+    std::size_t count {0};
+
+    for (std::size_t i = 0; i < N; ++i)
+    {
+      if (grid[i] == Type::newline)
+      {
+        ++count;
+      }
+    }
+
+    return count;
+  }
+
+  // cells in the first row of a template, including the newline
+  template<std::size_t N>
+  static constexpr std::size_t count_stride(std::array<int, N> const& grid)
+  {
+    std::size_t i {0};
+
+    while (i < N && grid[i] != Type::newline)
+    {
+      ++i;
+    }
+
+    return i + 1;
+  }
+
+  // set the buffer to a template, its block counts are known at compile time
+  template<auto const& grid>
+  void set_grid()
+  {
+    constexpr auto x_blocks = count_x_blocks(grid);
+    constexpr auto y_blocks = count_y_blocks(grid);
+    constexpr auto stride = count_stride(grid);
+    static_assert(stride * y_blocks == grid.size(), "template rows differ in length");
+
+    _ctx.buffer.resize(grid.size());
+    std::transform(grid.begin(), grid.end(), _ctx.buffer.begin(),
+      [](auto const cell) { return static_cast<Cell>(cell); });
+    _ctx.x_blocks = x_blocks;
+    _ctx.y_blocks = y_blocks;
+    _ctx.stride = stride;
+  }
+
+  // number of cells from first that hold the same type as first
+  static std::size_t count_run(Cell const* first, Cell const* last);
+
   void extract_digits(int const num, int& t0, int& t1) const;
   std::string set_fill(std::string const& fill) const;
 
   void init_ctx(std::size_t const width, std::size_t const height);
+  void step_style();
+
+  bool world() const;
+  std::size_t date_lines() const;
+  std::pair<std::size_t, std::size_t> world_grid(std::size_t const width, std::size_t const height) const;
 
   void calc_xy_block();
   void calc_xy_ratio();
@@ -581,9 +847,19 @@ private:
 
   // void draw_background(std::size_t const width, std::size_t const height, std::ostringstream& buf);
   // void draw_title(std::ostringstream& buf);
-  void draw_clock(std::ostringstream& buf);
-  void draw_ascii(std::ostringstream& buf);
-  void draw_date(std::ostringstream& buf);
+  void draw_clock(OB::Framebuffer& buf);
+
+  // background of a block type, stepping animated colours
+  OB::Color& block_bg(int const type);
+
+  // whether a run of blocks of a type can be drawn as a single span
+  bool mergeable(int const type);
+
+  // draw a run of 'n' blocks of a type as a single span
+  void draw_blocks(OB::Framebuffer& buf, int const type, std::size_t const n);
+  void draw_ascii(OB::Framebuffer& buf);
+  void draw_date(OB::Framebuffer& buf);
+  void draw_world(std::size_t const width, std::size_t const height, OB::Framebuffer& buf);
 };
 
 #endif // PEACLOCK_HH
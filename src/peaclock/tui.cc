@@ -7,8 +7,14 @@
 #include "ob/term.hh"
 namespace aec = OB::Term::ANSI_Escape_Codes;
 
+#include <poll.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <unistd.h>
+
 #include <ctime>
 #include <cmath>
+#include <cerrno>
 #include <cctype>
 #include <cstdio>
 #include <cstddef>
@@ -16,10 +22,12 @@ namespace aec = OB::Term::ANSI_Escape_Codes;
 #include <cstdlib>
 
 #include <string>
+#include <string_view>
 #include <sstream>
 #include <fstream>
 #include <iostream>
 #include <iomanip>
+#include <iterator>
 #include <vector>
 #include <chrono>
 #include <thread>
@@ -28,6 +36,9 @@ namespace aec = OB::Term::ANSI_Escape_Codes;
 #include <utility>
 #include <optional>
 #include <limits>
+#include <charconv>
+#include <functional>
+#include <initializer_list>
 
 #include <filesystem>
 namespace fs = std::filesystem;
@@ -39,11 +50,20 @@ static constexpr char const* btos(bool const x) {
   return x ? "on" : "off";
 }
 
+// write end of the self-pipe that wakes the event loop on a resize
+static int sigwinch_fd {-1};
+
+static void sigwinch_handler(int) {
+  int const err {errno};
+  [[maybe_unused]] auto const ec = write(sigwinch_fd, "", 1);
+  errno = err;
+}
+
 Tui::Tui(Parg const& parg) :
   _pg {parg},
   _colorterm {OB::Term::is_colorterm()}
 {
-  _ctx.prompt.timeout = _ctx.prompt.rate.get() / _ctx.refresh_rate.get();
+  init_commands();
 }
 
 bool Tui::press_to_continue(std::string const& str, char32_t val)
@@ -74,12 +94,12 @@ void Tui::base_config(fs::path const& path)
   _ctx.base_config = path;
 }
 
-void Tui::load_config(fs::path const& path)
+bool Tui::load_config(fs::path const& path, bool const prompt)
 {
   // ignore config if path equals "NONE"
   if (path == "NONE")
   {
-    return;
+    return true;
   }
 
   // buffer for error output
@@ -87,36 +107,80 @@ void Tui::load_config(fs::path const& path)
 
   if (! path.empty() && fs::exists(path))
   {
-    std::ifstream file {path};
+    std::ifstream file {path, std::ios::binary};
 
     if (file.is_open())
     {
-      std::string line;
+      // read the whole file at once
+      std::string const buf {std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+
+      // parse and validate every line before applying any of them
+      std::vector<std::pair<std::size_t, Action>> actions;
       std::size_t lnum {0};
 
-      while (std::getline(file, line))
+      for (std::size_t pos = 0; pos < buf.size();)
       {
+        auto end = buf.find('\n', pos);
+
+        if (end == std::string::npos)
+        {
+          end = buf.size();
+        }
+
+        auto line = std::string_view(buf).substr(pos, end - pos);
+        pos = end + 1;
+
         // increase line number
         ++lnum;
 
         // trim leading and trailing whitespace
-        line = OB::String::trim(line);
+        if (auto const begin = line.find_first_not_of(" \t\r"); begin != std::string_view::npos)
+        {
+          line = line.substr(begin, line.find_last_not_of(" \t\r") - begin + 1);
+        }
+        else
+        {
+          line = {};
+        }
 
         // ignore empty line or comment
-        if (line.empty() || OB::String::assert_rx(line, std::regex("^#[^\\r]*$")))
+        if (line.empty() || line.front() == '#')
+        {
+          continue;
+        }
+
+        auto parsed = parse(line);
+
+        if (! parsed.action)
         {
+          if (parsed.status && ! parsed.status.value().first)
+          {
+            // source:line: level: info
+            err << path.string() << ":" << lnum << ": " << parsed.status.value().second << "\n";
+          }
+
           continue;
         }
 
-        if (auto const res = command(line))
+        actions.emplace_back(lnum, std::move(parsed.action));
+      }
+
+      if (err.str().empty())
+      {
+        // apply the whole config
+        for (auto const& [num, action] : actions)
         {
-          if (! res.value().first)
+          if (auto const res = action(); res && ! res.value().first)
           {
             // source:line: level: info
-            err << path.string() << ":" << lnum << ": " << res.value().second << "\n";
+            err << path.string() << ":" << num << ": " << res.value().second << "\n";
           }
         }
       }
+      else
+      {
+        err << "error: the config file '" << path.string() << "' was not applied\n";
+      }
     }
     else
     {
@@ -128,20 +192,24 @@ void Tui::load_config(fs::path const& path)
     err << "error: the file '" << path.string() << "' does not exist\n";
   }
 
-  if (! err.str().empty())
+  if (err.str().empty())
   {
-    std::cerr << err.str();
+    return true;
+  }
 
-    if (! press_to_continue("ENTER", '\n'))
-    {
-      throw std::runtime_error("aborted by user");
-    }
+  std::cerr << err.str();
+
+  if (prompt && ! press_to_continue("ENTER", '\n'))
+  {
+    throw std::runtime_error("aborted by user");
   }
+
+  return false;
 }
 
-void Tui::load_hist_command(fs::path const& path)
+void Tui::load_hist_command(fs::path const& path, bool const save)
 {
-  _readline.hist_load(path);
+  _readline.hist_load(path, save);
 }
 
 bool Tui::mkconfig(std::string path, bool overwrite)
@@ -190,6 +258,7 @@ bool Tui::mkconfig(std::string path, bool overwrite)
   << "# date: " << std::put_time(&tm, "%FT%TZ") << "\n\n"
   << "mode " << Peaclock::Mode::str(_peaclock.cfg.mode) << "\n"
   << "view " << Peaclock::View::str(_peaclock.cfg.view) << "\n"
+  << "precision " << Peaclock::Precision::str(_peaclock.cfg.precision) << "\n"
   << "toggle " << Peaclock::Toggle::str(_peaclock.cfg.toggle) << "\n"
   << "stopwatch start\n"
   << "timer " << OB::Timer::sec_to_str(_peaclock.cfg.timer_seconds) << "\n"
@@ -197,12 +266,14 @@ bool Tui::mkconfig(std::string path, bool overwrite)
   << "date '" << OB::String::escape(_peaclock.cfg.datefmt) << "'\n"
   << "locale '" << _peaclock.cfg.locale << "'\n"
   << "timezone '" << _peaclock.cfg.timezone << "'\n"
+  << "zones '" << _peaclock.cfg.zones << "'\n"
   << "fill-colon '" << OB::String::escape(_peaclock.cfg.fill_colon) << "'\n"
   << "fill-active '" << OB::String::escape(_peaclock.cfg.fill_active) << "'\n"
   << "fill-inactive '" << OB::String::escape(_peaclock.cfg.fill_inactive) << "'\n"
   << "rate-input " << _ctx.input_interval.str() << "\n"
   << "rate-status " << _ctx.prompt.rate.str() << "\n"
   << "rate-refresh " << _ctx.refresh_rate.str() << "\n"
+  << "rate-fraction " << _ctx.fraction_rate.str() << "\n"
   << "block " << _peaclock.cfg.x_block.str() << " " << _peaclock.cfg.y_block.str() << "\n"
   << "padding " << _peaclock.cfg.x_space.str() << " " << _peaclock.cfg.y_space.str() << "\n"
   << "margin " << _peaclock.cfg.x_border.str() << " " << _peaclock.cfg.y_border.str() << "\n"
@@ -213,6 +284,8 @@ bool Tui::mkconfig(std::string path, bool overwrite)
   << "set hour-24 " << btos(_peaclock.cfg.hour_24) << "\n"
   << "set auto-size " << btos(_peaclock.cfg.auto_size) << "\n"
   << "set auto-ratio " << btos(_peaclock.cfg.auto_ratio) << "\n"
+  << "set damage " << btos(_ctx.damage) << "\n"
+  << "set sync " << btos(_ctx.sync) << "\n"
   << "style active-fg " << _peaclock.cfg.style.active_fg.key() << "\n"
   << "style active-bg " << _peaclock.cfg.style.active_bg.key() << "\n"
   << "style inactive-fg " << _peaclock.cfg.style.inactive_fg.key() << "\n"
@@ -234,6 +307,37 @@ bool Tui::mkconfig(std::string path, bool overwrite)
 
 void Tui::run()
 {
+  // wake the event loop through a self-pipe when the terminal is resized
+  if (pipe(_ctx.sigwinch) == -1)
+  {
+    throw std::runtime_error("pipe failed");
+  }
+
+  for (auto const fd : _ctx.sigwinch)
+  {
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+    fcntl(fd, F_SETFD, FD_CLOEXEC);
+  }
+
+  sigwinch_fd = _ctx.sigwinch[1];
+
+  // frames go through a separate nonblocking open of the terminal,
+  // leaving stdin and stdout blocking for the prompt and help pager
+  if (char const* name = ttyname(STDOUT_FILENO))
+  {
+    if (int const fd = open(name, O_WRONLY | O_NOCTTY | O_NONBLOCK | O_CLOEXEC); fd != -1)
+    {
+      _ctx.tty = fd;
+    }
+  }
+
+  struct sigaction sa {};
+  struct sigaction sa_old {};
+  sa.sa_handler = sigwinch_handler;
+  sigemptyset(&sa.sa_mask);
+  sa.sa_flags = SA_RESTART;
+  sigaction(SIGWINCH, &sa, &sa_old);
+
   std::cout
   << aec::cursor_hide
   << aec::screen_push
@@ -250,25 +354,110 @@ void Tui::run()
   // start the event loop
   event_loop();
 
+  _ctx.out.drain(_ctx.tty);
+
   std::cout
   << aec::mouse_disable
   << aec::nl
   << aec::screen_pop
   << aec::cursor_show
   << std::flush;
+
+  sigaction(SIGWINCH, &sa_old, nullptr);
+  sigwinch_fd = -1;
+
+  for (auto& fd : _ctx.sigwinch)
+  {
+    close(fd);
+    fd = -1;
+  }
+
+  if (_ctx.tty != STDOUT_FILENO)
+  {
+    close(_ctx.tty);
+    _ctx.tty = STDOUT_FILENO;
+  }
 }
 
-void Tui::event_loop()
+Tui::Event Tui::wait_event(int const timeout)
 {
-  while (_ctx.is_running)
+  // input queued while reading a terminal reply
+  if (OB::Term::input_pending())
+  {
+    return Event::input;
+  }
+
+  // wait for the terminal to take queued output, a negative fd is ignored
+  pollfd fds[3] {
+    {STDIN_FILENO, POLLIN, 0},
+    {_ctx.sigwinch[0], POLLIN, 0},
+    {_ctx.out.empty() ? -1 : _ctx.tty, POLLOUT, 0},
+  };
+
+  if (poll(fds, 3, timeout) == -1)
+  {
+    if (errno == EINTR)
+    {
+      return Event::none;
+    }
+
+    throw std::runtime_error("poll failed");
+  }
+
+  if (fds[1].revents & POLLIN)
   {
+    // drain the self-pipe
+    char buf[64];
+    while (read(_ctx.sigwinch[0], &buf[0], sizeof(buf)) > 0);
+
     // get the terminal width and height
     OB::Term::size(_ctx.width, _ctx.height);
 
+    return Event::resize;
+  }
+
+  if (fds[0].revents & POLLIN)
+  {
+    return Event::input;
+  }
+
+  if (fds[2].revents & (POLLOUT | POLLERR | POLLHUP))
+  {
+    // continue writing, once the queue empties a dropped frame is redrawn
+    if (_ctx.out.resume(_ctx.tty) && _ctx.stale)
+    {
+      return Event::output;
+    }
+
+    return Event::none;
+  }
+
+  if (fds[0].revents & (POLLHUP | POLLERR | POLLNVAL))
+  {
+    // the terminal has gone away
+    _ctx.is_running = false;
+
+    return Event::none;
+  }
+
+  return Event::timeout;
+}
+
+void Tui::event_loop()
+{
+  // get the terminal width and height
+  OB::Term::size(_ctx.width, _ctx.height);
+
+  while (_ctx.is_running)
+  {
     // check for correct screen size
     if (screen_size() != 0)
     {
-      std::this_thread::sleep_for(std::chrono::milliseconds(_ctx.input_interval));
+      // sleep until the terminal is resized or a key is pressed
+      if (wait_event(-1) != Event::input)
+      {
+        continue;
+      }
 
       char32_t key {0};
       if ((key = OB::Term::get_key()) > 0)
@@ -298,61 +487,149 @@ void Tui::event_loop()
     draw();
     refresh();
 
-    int wait {_ctx.refresh_rate.get()};
-    int tick {0};
+    _ctx.drawn = std::chrono::steady_clock::now();
 
-    while (_ctx.is_running && wait)
+    // sleep until the next redraw,
+    // waking early to handle input and resizes as soon as they arrive
+    while (_ctx.is_running)
     {
-      if (wait > _ctx.input_interval.get())
+      auto const event = wait_event(redraw_wait());
+
+      if (event == Event::timeout || event == Event::resize || event == Event::output)
       {
-        tick = _ctx.input_interval.get();
-        wait -= _ctx.input_interval.get();
+        break;
       }
-      else
+
+      if (event == Event::input)
       {
-        tick = wait;
-        wait = 0;
-      }
+        get_input();
 
-      std::this_thread::sleep_for(std::chrono::milliseconds(tick));
+        // the size may have changed while the prompt or help was open
+        OB::Term::size(_ctx.width, _ctx.height);
 
-      get_input();
+        break;
+      }
     }
   }
 }
 
+int Tui::redraw_wait()
+{
+  using namespace std::chrono;
+
+  // the next change of the displayed time
+  auto wait = ceil<milliseconds>(_peaclock.next_change());
+
+  // animated colours step on every refresh
+  if (_peaclock.animated())
+  {
+    wait = std::min(wait, ceil<milliseconds>(_ctx.drawn +
+      milliseconds(_ctx.refresh_rate.get()) - steady_clock::now()));
+  }
+
+  // fractions of a second change faster than a terminal can show them,
+  // a running stopwatch displaying them is redrawn at the fraction rate
+  if (_peaclock.fraction() && _peaclock.stopwatch)
+  {
+    wait = std::max(wait, ceil<milliseconds>(_ctx.drawn +
+      milliseconds(_ctx.fraction_rate.get()) - steady_clock::now()));
+  }
+
+  // the status message is cleared once it expires
+  if (auto const now = steady_clock::now(); now < _ctx.prompt.expire)
+  {
+    wait = std::min(wait, ceil<milliseconds>(_ctx.prompt.expire - now));
+  }
+
+  return wait.count() > 0 ? static_cast<int>(wait.count()) : 0;
+}
+
 void Tui::clear()
 {
   // clear screen
   _ctx.buf
-  << aec::cursor_home
-  << _ctx.style.background;
-
-  OB::Algorithm::for_each(_ctx.height,
-  [&](auto) {
-    OB::Algorithm::for_each(_ctx.width, [&](auto) {
-      _ctx.buf << " "; });
-    _ctx.buf << "\n";
-  },
-  [&](auto) {
-    OB::Algorithm::for_each(_ctx.width, [&](auto) {
-      _ctx.buf << " "; });
-  });
-
-  _ctx.buf
-  << aec::clear
-  << aec::cursor_home;
+  .size(_ctx.width, _ctx.height)
+  .clear(_ctx.style.background);
 }
 
 void Tui::refresh()
 {
-  // output buffer to screen
-  std::cout
-  << _ctx.buf.str()
-  << std::flush;
+  // the terminal has not taken the previous frame yet, drop this one
+  // instead of queueing behind it, the newest is drawn once the queue empties
+  if (! _ctx.out.empty())
+  {
+    _ctx.out.drop();
+    _ctx.stale = true;
+
+    return;
+  }
+
+  _ctx.stale = false;
+
+  if (_ctx.sync && ! _ctx.sync_support)
+  {
+    // DECRQM for mode 2026, set or reset means the mode is known
+    auto const res = aec::mode_get(2026, false);
+    _ctx.sync_support = res == 1 || res == 2;
+  }
+
+  flush(_ctx.tty, _ctx.sync && *_ctx.sync_support);
+}
+
+void Tui::render(std::size_t const width, std::size_t const height)
+{
+  _ctx.width = width;
+  _ctx.height = height;
+
+  clear();
+  draw();
+}
+
+void Tui::flush(int const fd, bool const sync)
+{
+  auto& out = _ctx.out.buf();
+
+  if (sync)
+  {
+    out += aec::sync_begin;
+  }
+
+  auto const size = out.size();
+
+  // encode the framebuffer into the output buffer
+  if (_ctx.damage)
+  {
+    // only the cells that differ from the previous frame
+    _ctx.buf.diff(_ctx.prev, out);
+  }
+  else
+  {
+    // every cell
+    _ctx.buf.encode(out);
+  }
+
+  if (sync)
+  {
+    if (out.size() == size)
+    {
+      // nothing changed, skip the empty update
+      out.clear();
+    }
+    else
+    {
+      out += aec::sync_end;
+    }
+  }
+
+  // output buffer to screen in a single write
+  _ctx.out.flush(fd);
 
-  // clear output buffer
-  _ctx.buf.str("");
+  _ctx.prev = _ctx.buf;
+}
+
+OB::Sink::Stats const& Tui::stats() const
+{
+  return _ctx.out.stats();
 }
 
 void Tui::draw()
@@ -364,9 +641,6 @@ void Tui::draw()
 
 void Tui::draw_content()
 {
-  _ctx.buf
-  << aec::cursor_save;
-
   // timer
   if (! _peaclock.timer && _peaclock.cfg.timer_notify)
   {
@@ -384,10 +658,6 @@ void Tui::draw_content()
 
   // render new content
   _peaclock.render(_ctx.width, _ctx.height, _ctx.buf);
-
-  _ctx.buf
-  << aec::clear
-  << aec::cursor_load;
 }
 
 void Tui::draw_keybuf()
@@ -397,46 +667,35 @@ void Tui::draw_keybuf()
     return;
   }
 
-  _ctx.buf
-  << aec::cursor_save
-  << aec::cursor_set(_ctx.width - 3, _ctx.height)
-  << _ctx.style.background
-  << "    "
-  << aec::cursor_set(_ctx.width - 3, _ctx.height)
-  << _ctx.style.text
-  << aec::space;
+  auto const bg = _ctx.buf.style(_ctx.style.background);
+  auto const fg = _ctx.buf.style(_ctx.style.text);
+
+  std::string str {aec::space};
 
   for (auto const& e : _ctx.keys)
   {
     if (OB::Text::is_print(static_cast<std::int32_t>(e.val)))
     {
-      _ctx.buf
-      << e.str;
+      str += e.str;
     }
   }
 
-  _ctx.buf
-  << aec::space
-  << aec::clear
-  << aec::cursor_load;
+  str += aec::space;
+
+  _ctx.buf.text(_ctx.width - 4, _ctx.height - 1, "    ", 0, bg);
+  _ctx.buf.text(_ctx.width - 4, _ctx.height - 1, str, fg, bg);
 }
 
 void Tui::draw_prompt_message()
 {
   // check if command prompt message is active
-  if (_ctx.prompt.count > 0)
+  if (std::chrono::steady_clock::now() < _ctx.prompt.expire)
   {
-    --_ctx.prompt.count;
-
-    _ctx.buf
-    << aec::cursor_save
-    << aec::cursor_set(0, _ctx.height)
-    << _ctx.style.background
-    << _ctx.style.prompt
-    << ">"
-    << _ctx.style.prompt_status
-    << _ctx.prompt.str.substr(0, _ctx.width - 5)
-    << aec::cursor_load;
+    auto const bg = _ctx.buf.style(_ctx.style.background);
+
+    _ctx.buf.text(0, _ctx.height - 1, ">", _ctx.buf.style(_ctx.style.prompt), bg);
+    _ctx.buf.text(1, _ctx.height - 1, _ctx.prompt.str.substr(0, _ctx.width - 5),
+      _ctx.buf.style(_ctx.style.prompt_status), bg);
   }
 }
 
@@ -444,7 +703,8 @@ void Tui::set_status(bool success, std::string const& msg)
 {
   _ctx.style.prompt_status = success ? _ctx.style.success : _ctx.style.error;
   _ctx.prompt.str = msg;
-  _ctx.prompt.count = _ctx.prompt.timeout;
+  _ctx.prompt.expire = std::chrono::steady_clock::now() +
+    std::chrono::milliseconds(_ctx.prompt.rate.get());
 }
 
 void Tui::get_input()
@@ -474,7 +734,7 @@ void Tui::get_input()
 
       case OB::Term::Key::escape:
       {
-        _ctx.prompt.count = 0;
+        _ctx.prompt.expire = {};
         _ctx.keys.clear();
 
         break;
@@ -1452,954 +1712,743 @@ void Tui::get_input()
   while (OB::Term::get_key(&_ctx.key.str) > 0);
 }
 
-std::optional<std::pair<bool, std::string>> Tui::command(std::string const& input)
+bool Tui::Args::parse(std::string_view const str)
 {
-  // quit
-  if (! _ctx.is_running)
-  {
-    _ctx.is_running = false;
-    return {};
-  }
+  line = str;
+  word.clear();
 
-  // nop
-  if (input.empty())
-  {
-    return {};
-  }
-
-  auto const keys = OB::String::split(input, " ", 2);
-
-  if (keys.empty())
-  {
-    return {};
-  }
+  std::size_t i {0};
 
-  // store the matches returned from OB::String::match
-  std::optional<std::vector<std::string>> match_opt;
-
-  // quit
-  if (keys.size() == 1 && (keys.at(0) == "q" || keys.at(0) == "Q" ||
-    keys.at(0) == "quit" || keys.at(0) == "Quit" || keys.at(0) == "exit"))
+  while (i < line.size())
   {
-    _ctx.is_running = false;
-    return {};
-  }
+    // skip whitespace
+    if (line.at(i) == ' ' || line.at(i) == '\t')
+    {
+      ++i;
 
-  else if (keys.at(0) == "h" || keys.at(0) == "help")
-  {
-    std::cout
-    << aec::mouse_disable
-    << aec::nl
-    << aec::screen_pop
-    << aec::cursor_show
-    << std::flush;
-
-    _term_mode.set_cooked();
-
-    std::system(("$(which less) -ir" +
-      (keys.size() > 1 ? " '+/" + keys.at(1) +
-      (keys.size() > 2 ? " " + keys.at(2) : "") + "'" : "") +
-      " <<'EOF'\n" + _pg.help() + "EOF").c_str());
-
-    _term_mode.set_raw();
-
-    std::cout
-    << aec::cursor_hide
-    << aec::screen_push
-    << aec::cursor_hide
-    << aec::screen_clear
-    << aec::cursor_home
-    << aec::mouse_enable
-    << std::flush;
-  }
+      continue;
+    }
 
-  else if (keys.at(0) == "timer" && (match_opt = OB::String::match(input,
-    std::regex("^timer(?:\\s+(clear|start|stop|(?:(?:\\d+Y)?:?(?:\\d+M)?:?(?:\\d+W)?:?(?:\\d+D)?:?(?:\\d+h)?:?(?:\\d+m)?:?(?:\\d+s)?)))?$"))))
-  {
-    auto const match = OB::String::trim(match_opt.value().at(1));
+    auto const begin = i;
 
-    if (match.empty())
+    if (line.at(i) == '\'' || line.at(i) == '"')
     {
-      return std::make_pair(true, "timer " + OB::Timer::sec_to_str(_peaclock.cfg.timer_seconds));
-      // return std::make_pair(true, "timer " + OB::Timer::sec_to_str(_peaclock.cfg.timer_seconds - _peaclock.timer.seconds()));
-    }
+      // quoted string, a backslash escapes the following char
+      auto const quote = line.at(i++);
 
-    if (match == "clear")
-    {
-      _peaclock.timer.reset();
-      _peaclock.cfg.timer_notify = false;
-    }
-    else if (match == "start")
-    {
-      if (_peaclock.timer.seconds() >= _peaclock.cfg.timer_seconds)
+      while (i < line.size() && line.at(i) != quote)
       {
-        _peaclock.timer.reset();
-        _peaclock.cfg.timer_notify = false;
+        i += static_cast<std::size_t>(line.at(i) == '\\' ? 2 : 1);
       }
 
-      _peaclock.timer.start();
-    }
-    else if (match == "stop")
-    {
-      _peaclock.timer.stop();
+      if (i >= line.size())
+      {
+        return false;
+      }
+
+      ++i;
+
+      // the closing quote must end the word
+      if (i < line.size() && line.at(i) != ' ' && line.at(i) != '\t')
+      {
+        return false;
+      }
     }
     else
     {
-      _peaclock.timer.reset();
-      _peaclock.cfg.timer_notify = false;
-      _peaclock.cfg.timer_seconds = OB::Timer::str_to_sec(match);
+      while (i < line.size() && line.at(i) != ' ' && line.at(i) != '\t')
+      {
+        ++i;
+      }
     }
+
+    word.emplace_back(line.substr(begin, i - begin));
   }
 
-  else if (keys.at(0) == "stopwatch" && (match_opt = OB::String::match(input,
-    std::regex("^stopwatch(?:\\s+(clear|start|stop|(?:(?:\\d+Y)?:?(?:\\d+M)?:?(?:\\d+W)?:?(?:\\d+D)?:?(?:\\d+h)?:?(?:\\d+m)?:?(?:\\d+s)?)))?$"))))
-  {
-    auto const match = OB::String::trim(match_opt.value().at(1));
+  return true;
+}
 
-    if (match.empty())
-    {
-      return std::make_pair(true, "stopwatch " + _peaclock.stopwatch.str());
-    }
+std::string_view Tui::Args::rest(std::size_t const i) const
+{
+  return line.substr(static_cast<std::size_t>(word.at(i).data() - line.data()));
+}
 
-    if (match == "clear")
-    {
-      _peaclock.stopwatch.reset();
-    }
-    else if (match == "start")
-    {
-      _peaclock.stopwatch.start();
-    }
-    else if (match == "stop")
-    {
-      _peaclock.stopwatch.stop();
-    }
-    else
-    {
-      _peaclock.stopwatch.str(match);
-    }
+// parse a boolean argument
+static std::optional<bool> parse_bool(std::string_view const str)
+{
+  if (str == "true" || str == "t" || str == "1" || str == "on")
+  {
+    return true;
   }
 
-  else if (keys.at(0) == "timer-exec" && (match_opt = OB::String::match(input,
-    std::regex("^timer-exec(?:\\s+(?:(" + _ctx.rx.str + ")))?$"))))
+  if (str == "false" || str == "f" || str == "0" || str == "off")
   {
-    auto const match = match_opt.value().at(1);
-
-    if (match.empty())
-    {
-      return std::make_pair(true, "timer-exec '" + OB::String::escape(_peaclock.cfg.timer_exec) + "'");
-    }
-    else
-    {
-      if (match.size() == 2)
-      {
-        _peaclock.cfg.timer_exec = "";
-      }
-      else
-      {
-        _peaclock.cfg.timer_exec = OB::String::unescape(match.substr(1, match.size() - 2));
-      }
-    }
+    return false;
   }
 
-  else if (keys.at(0) == "mkconfig" || keys.at(0) == "mkconfig!")
+  return {};
+}
+
+// parse an unsigned decimal argument
+template<typename T>
+static std::optional<T> parse_num(std::string_view const str)
+{
+  if (str.empty() || str.find_first_not_of("0123456789") != std::string_view::npos)
   {
-    if (keys.size() == 2)
-    {
-      mkconfig(keys.at(1), keys.at(0).back() == '!');
-    }
-    else
-    {
-      return std::make_pair(false, "error: expected output file path");
-    }
+    return {};
   }
 
-  else if (keys.at(0) == "rate-input" && (match_opt = OB::String::match(input,
-    std::regex("^rate-input(?:\\s+([0-9]+))?$"))))
+  T val {0};
+
+  if (auto const [ptr, ec] = std::from_chars(str.data(), str.data() + str.size(), val);
+    ec != std::errc())
   {
-    auto const match = match_opt.value().at(1);
+    return {};
+  }
 
-    if (match.empty())
-    {
-      return std::make_pair(true, "rate-input " + _ctx.input_interval.str());
-    }
-    else
-    {
-      _ctx.input_interval = std::stoi(match);
-    }
-  }
+  return val;
+}
 
-  else if (keys.at(0) == "rate-refresh" && (match_opt = OB::String::match(input,
-    std::regex("^rate-refresh(?:\\s+([0-9]+))?$"))))
+// parse a quoted string argument, returns the value between the quotes
+static std::optional<std::string> parse_str(std::string_view const str)
+{
+  if (str.size() < 2 || (str.front() != '\'' && str.front() != '"') ||
+    str.back() != str.front())
   {
-    auto const match = match_opt.value().at(1);
-
-    if (match.empty())
-    {
-      return std::make_pair(true, "rate-refresh " + _ctx.refresh_rate.str());
-    }
-    else
-    {
-      _ctx.refresh_rate = std::stoi(match);
-      _ctx.prompt.timeout = _ctx.prompt.rate.get() / _ctx.refresh_rate.get();
-    }
+    return {};
   }
 
-  else if (keys.at(0) == "rate-status" && (match_opt = OB::String::match(input,
-    std::regex("^rate-status(?:\\s+([0-9]+))?$"))))
-  {
-    auto const match = match_opt.value().at(1);
-
-    if (match.empty())
-    {
-      return std::make_pair(true, "rate-status " + _ctx.prompt.rate.str());
-    }
-    else
-    {
-      _ctx.prompt.rate = std::stoi(match);
-      _ctx.prompt.timeout = _ctx.prompt.rate.get() / _ctx.refresh_rate.get();
-    }
-  }
+  return std::string(str.substr(1, str.size() - 2));
+}
 
-  else if (keys.at(0) == "locale" && (match_opt = OB::String::match(input,
-    std::regex("^locale(?:\\s+(?:(" + _ctx.rx.str + ")))?$"))))
-  {
-    auto const match = match_opt.value().at(1);
+void Tui::init_commands()
+{
+  // duration argument of the timer and stopwatch commands
+  static std::regex const rx_duration {"^(?:\\d+Y)?:?(?:\\d+M)?:?(?:\\d+W)?:?(?:\\d+D)?:?(?:\\d+h)?:?(?:\\d+m)?:?(?:\\d+s)?$"};
 
-    if (match.empty())
-    {
-      return std::make_pair(true, "locale '" + _peaclock.cfg.locale + "'");
-    }
-    else
-    {
-      if (match.size() == 2)
-      {
-        _peaclock.cfg_locale("");
-      }
-      else if (! _peaclock.cfg_locale(match.substr(1, match.size() - 2)))
+  // get or set a boolean value
+  auto const cmd_bool = [](std::string const name, bool& val) -> Parser {
+    return [name, &val](Args const& args) -> Parsed {
+      if (args.word.size() == 2)
       {
-        return std::make_pair(false, "error: invalid locale '" + match.substr(1, match.size() - 2) + "'");
+        return {[name, &val]() -> Status {
+          return std::make_pair(true, name + " " + btos(val));
+        }};
       }
-    }
-  }
-
-  else if (keys.at(0) == "timezone" && (match_opt = OB::String::match(input,
-    std::regex("^timezone(?:\\s+(?:(" + _ctx.rx.str + ")))?$"))))
-  {
-    auto const match = match_opt.value().at(1);
 
-    if (match.empty())
-    {
-      return std::make_pair(true, "timezone '" + _peaclock.cfg.timezone + "'");
-    }
-    else
-    {
-      if (match.size() == 2)
+      if (args.word.size() == 3)
       {
-        _peaclock.cfg_timezone("");
-      }
-      else if (! _peaclock.cfg_timezone(match.substr(1, match.size() - 2)))
-      {
-        return std::make_pair(false, "error: invalid timezone '" + match.substr(1, match.size() - 2) + "'");
+        if (auto const res = parse_bool(args.word.at(2)))
+        {
+          return {[&val, res = res.value()]() noexcept -> Status {
+            val = res;
+            return {};
+          }};
+        }
       }
-    }
-  }
 
-  else if (keys.at(0) == "date" && (match_opt = OB::String::match(input,
-    std::regex("^date(?:\\s+(?:(" + _ctx.rx.str + ")))?$"))))
-  {
-    auto const match = match_opt.value().at(1);
+      return {};
+    };
+  };
 
-    if (match.empty())
-    {
-      return std::make_pair(true, "date '" + OB::String::escape(_peaclock.cfg.datefmt) + "'");
-    }
-    else
-    {
-      if (match.size() == 2)
-      {
-        _peaclock.cfg_datefmt("");
-      }
-      else
-      {
-        _peaclock.cfg_datefmt(OB::String::unescape(match.substr(1, match.size() - 2)));
-      }
-    }
-  }
-
-  else if (keys.at(0) == "fill" && (match_opt = OB::String::match(input,
-    std::regex("^fill(?:\\s+(?:(" + _ctx.rx.str + ")))?$"))))
-  {
-    auto const match = match_opt.value().at(1);
+  // get or set a number value
+  auto const cmd_num = [](std::string const name, auto& val) -> Parser {
+    using T = decltype(val.get());
 
-    if (match.empty())
-    {
-      return std::make_pair(true, "fill '" + OB::String::escape(_peaclock.cfg.fill_active) + "'");
-    }
-    else
-    {
-      if (match.size() == 2)
-      {
-        _peaclock.cfg.fill_active = "";
-        _peaclock.cfg.fill_inactive = "";
-        _peaclock.cfg.fill_colon = "";
-      }
-      else
+    return [name, &val](Args const& args) -> Parsed {
+      if (args.word.size() == 1)
       {
-        _peaclock.cfg.fill_active = OB::String::unescape(match.substr(1, match.size() - 2));
-        _peaclock.cfg.fill_inactive = _peaclock.cfg.fill_active;
-        _peaclock.cfg.fill_colon = _peaclock.cfg.fill_active;
+        return {[name, &val]() -> Status {
+          return std::make_pair(true, name + " " + val.str());
+        }};
       }
-    }
-  }
 
-  else if (keys.at(0) == "fill-active" && (match_opt = OB::String::match(input,
-    std::regex("^fill-active(?:\\s+(?:(" + _ctx.rx.str + ")))?$"))))
-  {
-    auto const match = match_opt.value().at(1);
-
-    if (match.empty())
-    {
-      return std::make_pair(true, "fill-active '" + OB::String::escape(_peaclock.cfg.fill_active) + "'");
-    }
-    else
-    {
-      if (match.size() == 2)
+      if (args.word.size() == 2)
       {
-        _peaclock.cfg.fill_active = "";
-      }
-      else
-      {
-        _peaclock.cfg.fill_active = OB::String::unescape(match.substr(1, match.size() - 2));
+        if (auto const res = parse_num<T>(args.word.at(1)))
+        {
+          return {[&val, res = res.value()]() -> Status {
+            val = res;
+            return {};
+          }};
+        }
       }
-    }
-  }
 
-  else if (keys.at(0) == "fill-inactive" && (match_opt = OB::String::match(input,
-    std::regex("^fill-inactive(?:\\s+(?:(" + _ctx.rx.str + ")))?$"))))
-  {
-    auto const match = match_opt.value().at(1);
+      return {};
+    };
+  };
 
-    if (match.empty())
-    {
-      return std::make_pair(true, "fill-inactive '" + OB::String::escape(_peaclock.cfg.fill_inactive) + "'");
-    }
-    else
-    {
-      if (match.size() == 2)
-      {
-        _peaclock.cfg.fill_inactive = "";
-      }
-      else
+  // get or set a pair of x and y number values
+  auto const cmd_xy = [](std::string const name, OB::num_size& x, OB::num_size& y) -> Parser {
+    return [name, &x, &y](Args const& args) -> Parsed {
+      if (args.word.size() == 1)
       {
-        _peaclock.cfg.fill_inactive = OB::String::unescape(match.substr(1, match.size() - 2));
+        return {[name, &x, &y]() -> Status {
+          return std::make_pair(true, name + " " + x.str() + " " + y.str());
+        }};
       }
-    }
-  }
-
-  else if (keys.at(0) == "fill-colon" && (match_opt = OB::String::match(input,
-    std::regex("^fill-colon(?:\\s+(?:(" + _ctx.rx.str + ")))?$"))))
-  {
-    auto const match = match_opt.value().at(1);
 
-    if (match.empty())
-    {
-      return std::make_pair(true, "fill-colon '" + OB::String::escape(_peaclock.cfg.fill_colon) + "'");
-    }
-    else
-    {
-      if (match.size() == 2)
-      {
-        _peaclock.cfg.fill_colon = "";
-      }
-      else
+      if (args.word.size() == 3)
       {
-        _peaclock.cfg.fill_colon = OB::String::unescape(match.substr(1, match.size() - 2));
-      }
-    }
-  }
-
-  else if (keys.at(0) == "mode" && (match_opt = OB::String::match(input,
-    std::regex("^mode(?:\\s+(clock|timer|stopwatch))?$"))))
-  {
-    auto const match = match_opt.value().at(1);
-
-    if (match.empty())
-    {
-      return std::make_pair(true, "mode " + Peaclock::Mode::str(_peaclock.cfg.mode));
-    }
-    else
-    {
-      _peaclock.cfg.mode = Peaclock::Mode::enm(match);
-    }
-  }
-
-  else if (keys.at(0) == "view" && (match_opt = OB::String::match(input,
-    std::regex("^view(?:\\s+(date|ascii|digital|binary|icon))?$"))))
-  {
-    auto const match = match_opt.value().at(1);
-
-    if (match.empty())
-    {
-      return std::make_pair(true, "view " + Peaclock::View::str(_peaclock.cfg.view));
-    }
-    else
-    {
-      _peaclock.cfg.view = Peaclock::View::enm(match);
-    }
-  }
-
-  else if (keys.at(0) == "toggle" && (match_opt = OB::String::match(input,
-    std::regex("^toggle(?:\\s+(block|padding|margin|ratio|active-fg|inactive-fg|colon-fg|active-bg|inactive-bg|colon-bg|date|background))?$"))))
-  {
-    auto const match = match_opt.value().at(1);
-
-    if (match.empty())
-    {
-      return std::make_pair(true, "toggle " + Peaclock::Toggle::str(_peaclock.cfg.toggle));
-    }
-    else
-    {
-      _peaclock.cfg.toggle = Peaclock::Toggle::enm(match);
-    }
-  }
-
-  else if (keys.at(0) == "date-padding" && (match_opt = OB::String::match(input,
-    std::regex("^date-padding(?:\\s+([0-9]+))?$"))))
-  {
-    auto const x = match_opt.value().at(1);
-
-    if (x.empty())
-    {
-      return std::make_pair(true, "date-padding " + _peaclock.cfg.date_padding.str());
-    }
-    else
-    {
-      _peaclock.cfg.date_padding = std::stoul(x);
-    }
-  }
-
-  else if (keys.at(0) == "block" && (match_opt = OB::String::match(input,
-    std::regex("^block(?:\\s+([0-9]+)\\s+([0-9]+))?$"))))
-  {
-    auto const x = match_opt.value().at(1);
-    auto const y = match_opt.value().at(2);
-
-    if (x.empty() && y.empty())
-    {
-      return std::make_pair(true, "block " + _peaclock.cfg.x_block.str() + " " + _peaclock.cfg.y_block.str());
-    }
-    else
-    {
-      _peaclock.cfg.x_block = std::stoul(x);
-      _peaclock.cfg.y_block = std::stoul(y);
-    }
-  }
-
-  else if (keys.at(0) == "block-x" && (match_opt = OB::String::match(input,
-    std::regex("^block-x(?:\\s+([0-9]+))?$"))))
-  {
-    auto const x = match_opt.value().at(1);
-
-    if (x.empty())
-    {
-      return std::make_pair(true, "block-x " + _peaclock.cfg.x_block.str());
-    }
-    else
-    {
-      _peaclock.cfg.x_block = std::stoul(x);
-    }
-  }
-
-  else if (keys.at(0) == "block-y" && (match_opt = OB::String::match(input,
-    std::regex("^block-y(?:\\s+([0-9]+))?$"))))
-  {
-    auto const y = match_opt.value().at(1);
-
-    if (y.empty())
-    {
-      return std::make_pair(true, "block-y " + _peaclock.cfg.y_block.str());
-    }
-    else
-    {
-      _peaclock.cfg.y_block = std::stoul(y);
-    }
-  }
-
-  else if (keys.at(0) == "padding" && (match_opt = OB::String::match(input,
-    std::regex("^padding(?:\\s+([0-9]+)\\s+([0-9]+))?$"))))
-  {
-    auto const x = match_opt.value().at(1);
-    auto const y = match_opt.value().at(2);
-
-    if (x.empty() && y.empty())
-    {
-      return std::make_pair(true, "padding " + _peaclock.cfg.x_space.str() + " " + _peaclock.cfg.y_space.str());
-    }
-    else
-    {
-      _peaclock.cfg.x_space = std::stoul(x);
-      _peaclock.cfg.y_space = std::stoul(y);
-    }
-  }
-
-  else if (keys.at(0) == "padding-x" && (match_opt = OB::String::match(input,
-    std::regex("^padding-x(?:\\s+([0-9]+))?$"))))
-  {
-    auto const x = match_opt.value().at(1);
-
-    if (x.empty())
-    {
-      return std::make_pair(true, "padding-x " + _peaclock.cfg.x_space.str());
-    }
-    else
-    {
-      _peaclock.cfg.x_space = std::stoul(x);
-    }
-  }
-
-  else if (keys.at(0) == "padding-y" && (match_opt = OB::String::match(input,
-    std::regex("^padding-y(?:\\s+([0-9]+))?$"))))
-  {
-    auto const y = match_opt.value().at(1);
-
-    if (y.empty())
-    {
-      return std::make_pair(true, "padding-y " + _peaclock.cfg.y_space.str());
-    }
-    else
-    {
-      _peaclock.cfg.y_space = std::stoul(y);
-    }
-  }
-
-  else if (keys.at(0) == "margin" && (match_opt = OB::String::match(input,
-    std::regex("^margin(?:\\s+([0-9]+)\\s+([0-9]+))?$"))))
-  {
-    auto const x = match_opt.value().at(1);
-    auto const y = match_opt.value().at(2);
-
-    if (x.empty() && y.empty())
-    {
-      return std::make_pair(true, "margin " + _peaclock.cfg.x_border.str() + " " + _peaclock.cfg.y_border.str());
-    }
-    else
-    {
-      _peaclock.cfg.x_border = std::stoul(x);
-      _peaclock.cfg.y_border = std::stoul(y);
-    }
-  }
-
-  else if (keys.at(0) == "margin-x" && (match_opt = OB::String::match(input,
-    std::regex("^margin-x(?:\\s+([0-9]+))?$"))))
-  {
-    auto const x = match_opt.value().at(1);
-
-    if (x.empty())
-    {
-      return std::make_pair(true, "margin-x " + _peaclock.cfg.x_border.str());
-    }
-    else
-    {
-      _peaclock.cfg.x_border = std::stoul(x);
-    }
-  }
-
-  else if (keys.at(0) == "margin-y" && (match_opt = OB::String::match(input,
-    std::regex("^margin-y(?:\\s+([0-9]+))?$"))))
-  {
-    auto const y = match_opt.value().at(1);
-
-    if (y.empty())
-    {
-      return std::make_pair(true, "margin-y " + _peaclock.cfg.y_border.str());
-    }
-    else
-    {
-      _peaclock.cfg.y_border = std::stoul(y);
-    }
-  }
-
-  else if (keys.at(0) == "ratio" && (match_opt = OB::String::match(input,
-    std::regex("^ratio(?:\\s+([0-9]+)\\s+([0-9]+))?$"))))
-  {
-    auto const x = match_opt.value().at(1);
-    auto const y = match_opt.value().at(2);
-
-    if (x.empty() && y.empty())
-    {
-      return std::make_pair(true, "ratio " + _peaclock.cfg.x_ratio.str() + " " + _peaclock.cfg.y_ratio.str());
-    }
-    else
-    {
-      _peaclock.cfg.x_ratio = std::stoul(x);
-      _peaclock.cfg.y_ratio = std::stoul(y);
-    }
-  }
-
-  else if (keys.at(0) == "ratio-x" && (match_opt = OB::String::match(input,
-    std::regex("^ratio-x(?:\\s+([0-9]+))?$"))))
-  {
-    auto const x = match_opt.value().at(1);
+        auto const res_x = parse_num<std::size_t>(args.word.at(1));
+        auto const res_y = parse_num<std::size_t>(args.word.at(2));
 
-    if (x.empty())
-    {
-      return std::make_pair(true, "ratio-x " + _peaclock.cfg.x_ratio.str());
-    }
-    else
-    {
-      _peaclock.cfg.x_ratio = std::stoul(x);
-    }
-  }
+        if (res_x && res_y)
+        {
+          return {[&x, &y, res_x = res_x.value(), res_y = res_y.value()]() -> Status {
+            x = res_x;
+            y = res_y;
+            return {};
+          }};
+        }
+      }
 
-  else if (keys.at(0) == "ratio-y" && (match_opt = OB::String::match(input,
-    std::regex("^ratio-y(?:\\s+([0-9]+))?$"))))
-  {
-    auto const y = match_opt.value().at(1);
+      return {};
+    };
+  };
 
-    if (y.empty())
-    {
-      return std::make_pair(true, "ratio-y " + _peaclock.cfg.y_ratio.str());
-    }
-    else
-    {
-      _peaclock.cfg.y_ratio = std::stoul(y);
-    }
-  }
-
-  else if (keys.size() >= 2 && keys.at(0) == "style")
-  {
-    if (keys.at(1) == "active-fg")
-    {
-      if (keys.size() < 3)
+  // get or set a quoted string value
+  auto const cmd_str = [](std::string const name, std::function<std::string()> get,
+    std::function<void(std::string const&)> set) -> Parser {
+    return [name, get, set](Args const& args) -> Parsed {
+      if (args.word.size() == 1)
       {
-        return std::make_pair(true, "style active-fg " + _peaclock.cfg.style.active_fg.key());
+        return {[name, get]() -> Status {
+          return std::make_pair(true, name + " '" + OB::String::escape(get()) + "'");
+        }};
       }
 
-      OB::Color color {keys.at(2)};
-
-      if (! color)
+      if (args.word.size() == 2)
       {
-        return std::make_pair(false, "warning: unknown command '" + input + "'");
+        if (auto const res = parse_str(args.word.at(1)))
+        {
+          return {[set, res = OB::String::unescape(res.value())]() -> Status {
+            set(res);
+            return {};
+          }};
+        }
       }
 
-      _peaclock.cfg.style.active_fg = color;
-    }
+      return {};
+    };
+  };
 
-    else if (keys.at(1) == "active-bg")
-    {
-      if (keys.size() < 3)
+  // get or set a colour value
+  auto const cmd_style = [](std::string const name, OB::Color::Type::value const type,
+    std::vector<OB::Color*> const val) -> Parser {
+    return [name, type, val](Args const& args) -> Parsed {
+      if (args.word.size() == 2)
       {
-        return std::make_pair(true, "style active-bg " + _peaclock.cfg.style.active_bg.key());
+        return {[name, val]() -> Status {
+          return std::make_pair(true, name + " " + val.front()->key());
+        }};
       }
 
-      OB::Color color {keys.at(2), OB::Color::Type::bg};
+      OB::Color color {std::string(args.rest(2)), type};
 
       if (! color)
       {
-        return std::make_pair(false, "warning: unknown command '" + input + "'");
+        return {};
       }
 
-      _peaclock.cfg.style.active_bg = color;
-    }
-
-    else if (keys.at(1) == "inactive-fg")
-    {
-      if (keys.size() < 3)
-      {
-        return std::make_pair(true, "style inactive-fg " + _peaclock.cfg.style.inactive_fg.key());
-      }
+      return {[val, color]() -> Status {
+        for (auto* e : val)
+        {
+          *e = color;
+        }
 
-      OB::Color color {keys.at(2)};
+        return {};
+      }};
+    };
+  };
 
-      if (! color)
+  // get or set one of a fixed set of names
+  auto const cmd_enum = [](std::string const name, std::vector<std::string_view> const names,
+    std::function<std::string()> get, std::function<void(std::string const&)> set) -> Parser {
+    return [name, names, get, set](Args const& args) -> Parsed {
+      if (args.word.size() == 1)
       {
-        return std::make_pair(false, "warning: unknown command '" + input + "'");
+        return {[name, get]() -> Status {
+          return std::make_pair(true, name + " " + get());
+        }};
       }
 
-      _peaclock.cfg.style.inactive_fg = color;
-    }
-
-    else if (keys.at(1) == "inactive-bg")
-    {
-      if (keys.size() < 3)
+      if (args.word.size() == 2 &&
+        std::find(names.begin(), names.end(), args.word.at(1)) != names.end())
       {
-        return std::make_pair(true, "style inactive-bg " + _peaclock.cfg.style.inactive_bg.key());
+        return {[set, res = std::string(args.word.at(1))]() -> Status {
+          set(res);
+          return {};
+        }};
       }
 
-      OB::Color color {keys.at(2), OB::Color::Type::bg};
+      return {};
+    };
+  };
 
-      if (! color)
+  // get, set, or control a timer
+  auto const cmd_timer = [](std::string const name, std::function<std::string()> get,
+    std::function<void(std::string const&)> set) -> Parser {
+    return [name, get, set](Args const& args) -> Parsed {
+      if (args.word.size() == 1)
       {
-        return std::make_pair(false, "warning: unknown command '" + input + "'");
+        return {[name, get]() -> Status {
+          return std::make_pair(true, name + " " + get());
+        }};
       }
 
-      _peaclock.cfg.style.inactive_bg = color;
-    }
-
-    else if (keys.at(1) == "colon-fg")
-    {
-      if (keys.size() < 3)
+      if (args.word.size() == 2 && (args.word.at(1) == "clear" ||
+        args.word.at(1) == "start" || args.word.at(1) == "stop" ||
+        std::regex_match(args.word.at(1).begin(), args.word.at(1).end(), rx_duration)))
       {
-        return std::make_pair(true, "style colon-fg " + _peaclock.cfg.style.colon_fg.key());
+        return {[set, res = std::string(args.word.at(1))]() -> Status {
+          set(res);
+          return {};
+        }};
       }
 
-      OB::Color color {keys.at(2)};
+      return {};
+    };
+  };
 
-      if (! color)
+  _commands = {
+    {"q", [&](Args const& args) noexcept -> Parsed {
+      if (args.word.size() != 1)
       {
-        return std::make_pair(false, "warning: unknown command '" + input + "'");
+        return {};
       }
 
-      _peaclock.cfg.style.colon_fg = color;
-    }
+      return {[&]() noexcept -> Status {
+        _ctx.is_running = false;
+        return {};
+      }};
+    }},
 
-    else if (keys.at(1) == "colon-bg")
-    {
-      if (keys.size() < 3)
-      {
-        return std::make_pair(true, "style colon-bg " + _peaclock.cfg.style.colon_bg.key());
-      }
+    {"help", [&](Args const& args) -> Parsed {
+      return {[&, search = std::string(args.word.size() > 1 ? args.rest(1) : "")]() -> Status {
+        // queued frames are written before leaving the screen
+        _ctx.out.drain(_ctx.tty);
 
-      OB::Color color {keys.at(2), OB::Color::Type::bg};
+        std::cout
+        << aec::mouse_disable
+        << aec::nl
+        << aec::screen_pop
+        << aec::cursor_show
+        << std::flush;
 
-      if (! color)
-      {
-        return std::make_pair(false, "warning: unknown command '" + input + "'");
-      }
+        _term_mode.set_cooked();
 
-      _peaclock.cfg.style.colon_bg = color;
-    }
+        std::system(("$(which less) -ir" +
+          (search.empty() ? "" : " '+/" + search + "'") +
+          " <<'EOF'\n" + _pg.help() + "EOF").c_str());
 
-    else if (keys.at(1) == "date")
-    {
-      if (keys.size() < 3)
-      {
-        return std::make_pair(true, "style date " + _peaclock.cfg.style.date.key());
-      }
+        _term_mode.set_raw();
 
-      OB::Color color {keys.at(2)};
+        std::cout
+        << aec::cursor_hide
+        << aec::screen_push
+        << aec::cursor_hide
+        << aec::screen_clear
+        << aec::cursor_home
+        << aec::mouse_enable
+        << std::flush;
 
-      if (! color)
-      {
-        return std::make_pair(false, "warning: unknown command '" + input + "'");
-      }
+        _ctx.prev.invalidate();
 
-      _peaclock.cfg.style.date = color;
-    }
+        return {};
+      }};
+    }},
 
-    else if (keys.at(1) == "text")
-    {
-      if (keys.size() < 3)
+    {"mkconfig", [&](Args const& args) -> Parsed {
+      if (args.word.size() != 2)
       {
-        return std::make_pair(true, "style text " + _ctx.style.text.key());
+        return {{}, std::make_pair(false, "error: expected output file path")};
       }
 
-      OB::Color color {keys.at(2)};
+      return {[&, path = std::string(args.word.at(1)), overwrite = args.word.at(0).back() == '!']() -> Status {
+        mkconfig(path, overwrite);
+        return {};
+      }};
+    }},
 
-      if (! color)
+    {"stats", [&](Args const& args) noexcept -> Parsed {
+      if (args.word.size() != 1)
       {
-        return std::make_pair(false, "warning: unknown command '" + input + "'");
+        return {};
       }
 
-      _ctx.style.text = color;
-    }
+      return {[&]() -> Status {
+        auto const& stats = _ctx.out.stats();
+        return std::make_pair(true, "frames " + std::to_string(stats.frames) +
+          " dropped " + std::to_string(stats.dropped) +
+          " bytes last " + std::to_string(stats.last) +
+          " avg " + std::to_string(stats.avg()) +
+          " max " + std::to_string(stats.max) +
+          " total " + std::to_string(stats.total));
+      }};
+    }},
+
+    {"timer", cmd_timer("timer",
+      [&]() {
+        return OB::Timer::sec_to_str(_peaclock.cfg.timer_seconds);
+      },
+      [&](std::string const& val) {
+        if (val == "clear")
+        {
+          _peaclock.timer.reset();
+          _peaclock.cfg.timer_notify = false;
+        }
+        else if (val == "start")
+        {
+          if (_peaclock.timer.seconds() >= _peaclock.cfg.timer_seconds)
+          {
+            _peaclock.timer.reset();
+            _peaclock.cfg.timer_notify = false;
+          }
 
-    else if (keys.at(1) == "background")
-    {
-      if (keys.size() < 3)
-      {
-        return std::make_pair(true, "style background " + _ctx.style.background.key());
-      }
+          _peaclock.timer.start();
+        }
+        else if (val == "stop")
+        {
+          _peaclock.timer.stop();
+        }
+        else
+        {
+          _peaclock.timer.reset();
+          _peaclock.cfg.timer_notify = false;
+          _peaclock.cfg.timer_seconds = OB::Timer::str_to_sec(val);
+        }
+      })},
+
+    {"stopwatch", cmd_timer("stopwatch",
+      [&]() {
+        return _peaclock.stopwatch.str();
+      },
+      [&](std::string const& val) {
+        if (val == "clear")
+        {
+          _peaclock.stopwatch.reset();
+        }
+        else if (val == "start")
+        {
+          _peaclock.stopwatch.start();
+        }
+        else if (val == "stop")
+        {
+          _peaclock.stopwatch.stop();
+        }
+        else
+        {
+          _peaclock.stopwatch.str(val);
+        }
+      })},
 
-      OB::Color color {keys.at(2), OB::Color::Type::bg};
+    {"timer-exec", cmd_str("timer-exec",
+      [&]() {
+        return _peaclock.cfg.timer_exec;
+      },
+      [&](std::string const& val) {
+        _peaclock.cfg.timer_exec = val;
+      })},
 
-      if (! color)
+    {"rate-input", cmd_num("rate-input", _ctx.input_interval)},
+    {"rate-refresh", cmd_num("rate-refresh", _ctx.refresh_rate)},
+    {"rate-fraction", cmd_num("rate-fraction", _ctx.fraction_rate)},
+    {"rate-status", cmd_num("rate-status", _ctx.prompt.rate)},
+
+    {"locale", [&](Args const& args) -> Parsed {
+      if (args.word.size() == 1)
       {
-        return std::make_pair(false, "warning: unknown command '" + input + "'");
+        return {[&]() -> Status {
+          return std::make_pair(true, "locale '" + _peaclock.cfg.locale + "'");
+        }};
       }
 
-      _ctx.style.background = color;
-      _peaclock.cfg.style.background = color;
-    }
-
-    else if (keys.at(1) == "prompt")
-    {
-      if (keys.size() < 3)
+      if (args.word.size() == 2)
       {
-        return std::make_pair(true, "style prompt " + _ctx.style.prompt.key());
+        if (auto const res = parse_str(args.word.at(1)))
+        {
+          // check that the locale exists before applying it
+          try
+          {
+            if (! res.value().empty())
+            {
+              [[maybe_unused]] auto const tmp = std::locale(res.value());
+            }
+          }
+          catch (...)
+          {
+            return {{}, std::make_pair(false, "error: invalid locale '" + res.value() + "'")};
+          }
+
+          return {[&, res = res.value()]() -> Status {
+            _peaclock.cfg_locale(res);
+            return {};
+          }};
+        }
       }
 
-      OB::Color color {keys.at(2)};
+      return {};
+    }},
 
-      if (! color)
+    {"timezone", [&](Args const& args) -> Parsed {
+      if (args.word.size() == 1)
       {
-        return std::make_pair(false, "warning: unknown command '" + input + "'");
+        return {[&]() -> Status {
+          return std::make_pair(true, "timezone '" + _peaclock.cfg.timezone + "'");
+        }};
       }
 
-      _ctx.style.prompt = color;
-    }
-
-    else if (keys.at(1) == "success")
-    {
-      if (keys.size() < 3)
+      if (args.word.size() == 2)
       {
-        return std::make_pair(true, "style success " + _ctx.style.success.key());
-      }
+        if (auto const res = parse_str(args.word.at(1)))
+        {
+          auto zone = Peaclock::load_timezone(res.value());
 
-      OB::Color color {keys.at(2)};
+          if (! zone)
+          {
+            return {{}, std::make_pair(false, "error: invalid timezone '" + res.value() + "'")};
+          }
 
-      if (! color)
-      {
-        return std::make_pair(false, "warning: unknown command '" + input + "'");
+          return {[&, res = res.value(), zone = std::move(zone.value())]() mutable -> Status {
+            _peaclock.cfg_timezone(res, std::move(zone));
+            return {};
+          }};
+        }
       }
 
-      _ctx.style.success = color;
-    }
+      return {};
+    }},
 
-    else if (keys.at(1) == "error")
-    {
-      if (keys.size() < 3)
+    {"zones", [&](Args const& args) -> Parsed {
+      if (args.word.size() == 1)
       {
-        return std::make_pair(true, "style error " + _ctx.style.error.key());
+        return {[&]() -> Status {
+          return std::make_pair(true, "zones '" + _peaclock.cfg.zones + "'");
+        }};
       }
 
-      OB::Color color {keys.at(2)};
-
-      if (! color)
+      if (args.word.size() == 2)
       {
-        return std::make_pair(false, "warning: unknown command '" + input + "'");
-      }
+        if (auto const res = parse_str(args.word.at(1)))
+        {
+          auto zones = Peaclock::load_zones(res.value());
 
-      _ctx.style.error = color;
-    }
+          if (! zones)
+          {
+            return {{}, std::make_pair(false, "error: invalid zones '" + res.value() + "'")};
+          }
 
-    else
-    {
-      return std::make_pair(false, "warning: unknown command '" + input + "'");
-    }
-  }
+          return {[&, res = res.value(), zones = std::move(zones.value())]() mutable -> Status {
+            _peaclock.cfg_zones(res, std::move(zones));
+            return {};
+          }};
+        }
+      }
 
-  else if (keys.size() >= 2 && keys.at(0) == "set")
+      return {};
+    }},
+
+    {"date", cmd_str("date",
+      [&]() {
+        return _peaclock.cfg.datefmt;
+      },
+      [&](std::string const& val) {
+        _peaclock.cfg_datefmt(val);
+      })},
+
+    {"fill", cmd_str("fill",
+      [&]() {
+        return _peaclock.cfg.fill_active;
+      },
+      [&](std::string const& val) {
+        _peaclock.cfg.fill_active = val;
+        _peaclock.cfg.fill_inactive = val;
+        _peaclock.cfg.fill_colon = val;
+      })},
+
+    {"fill-active", cmd_str("fill-active",
+      [&]() {
+        return _peaclock.cfg.fill_active;
+      },
+      [&](std::string const& val) {
+        _peaclock.cfg.fill_active = val;
+      })},
+
+    {"fill-inactive", cmd_str("fill-inactive",
+      [&]() {
+        return _peaclock.cfg.fill_inactive;
+      },
+      [&](std::string const& val) {
+        _peaclock.cfg.fill_inactive = val;
+      })},
+
+    {"fill-colon", cmd_str("fill-colon",
+      [&]() {
+        return _peaclock.cfg.fill_colon;
+      },
+      [&](std::string const& val) {
+        _peaclock.cfg.fill_colon = val;
+      })},
+
+    {"mode", cmd_enum("mode", {"clock", "timer", "stopwatch"},
+      [&]() {
+        return Peaclock::Mode::str(_peaclock.cfg.mode);
+      },
+      [&](std::string const& val) {
+        _peaclock.cfg.mode = Peaclock::Mode::enm(val);
+      })},
+
+    {"view", cmd_enum("view", {"date", "ascii", "digital", "binary", "icon"},
+      [&]() {
+        return Peaclock::View::str(_peaclock.cfg.view);
+      },
+      [&](std::string const& val) {
+        _peaclock.cfg.view = Peaclock::View::enm(val);
+      })},
+
+    {"precision", cmd_enum("precision", {"second", "centisecond", "millisecond"},
+      [&]() {
+        return Peaclock::Precision::str(_peaclock.cfg.precision);
+      },
+      [&](std::string const& val) {
+        _peaclock.cfg.precision = Peaclock::Precision::enm(val);
+      })},
+
+    {"toggle", cmd_enum("toggle", {"block", "padding", "margin", "ratio",
+      "active-fg", "inactive-fg", "colon-fg", "active-bg", "inactive-bg",
+      "colon-bg", "date", "background"},
+      [&]() {
+        return Peaclock::Toggle::str(_peaclock.cfg.toggle);
+      },
+      [&](std::string const& val) {
+        _peaclock.cfg.toggle = Peaclock::Toggle::enm(val);
+      })},
+
+    {"date-padding", cmd_num("date-padding", _peaclock.cfg.date_padding)},
+
+    {"block", cmd_xy("block", _peaclock.cfg.x_block, _peaclock.cfg.y_block)},
+    {"block-x", cmd_num("block-x", _peaclock.cfg.x_block)},
+    {"block-y", cmd_num("block-y", _peaclock.cfg.y_block)},
+
+    {"padding", cmd_xy("padding", _peaclock.cfg.x_space, _peaclock.cfg.y_space)},
+    {"padding-x", cmd_num("padding-x", _peaclock.cfg.x_space)},
+    {"padding-y", cmd_num("padding-y", _peaclock.cfg.y_space)},
+
+    {"margin", cmd_xy("margin", _peaclock.cfg.x_border, _peaclock.cfg.y_border)},
+    {"margin-x", cmd_num("margin-x", _peaclock.cfg.x_border)},
+    {"margin-y", cmd_num("margin-y", _peaclock.cfg.y_border)},
+
+    {"ratio", cmd_xy("ratio", _peaclock.cfg.x_ratio, _peaclock.cfg.y_ratio)},
+    {"ratio-x", cmd_num("ratio-x", _peaclock.cfg.x_ratio)},
+    {"ratio-y", cmd_num("ratio-y", _peaclock.cfg.y_ratio)},
+
+    {"style active-fg", cmd_style("style active-fg", OB::Color::Type::fg, {&_peaclock.cfg.style.active_fg})},
+    {"style active-bg", cmd_style("style active-bg", OB::Color::Type::bg, {&_peaclock.cfg.style.active_bg})},
+    {"style inactive-fg", cmd_style("style inactive-fg", OB::Color::Type::fg, {&_peaclock.cfg.style.inactive_fg})},
+    {"style inactive-bg", cmd_style("style inactive-bg", OB::Color::Type::bg, {&_peaclock.cfg.style.inactive_bg})},
+    {"style colon-fg", cmd_style("style colon-fg", OB::Color::Type::fg, {&_peaclock.cfg.style.colon_fg})},
+    {"style colon-bg", cmd_style("style colon-bg", OB::Color::Type::bg, {&_peaclock.cfg.style.colon_bg})},
+    {"style date", cmd_style("style date", OB::Color::Type::fg, {&_peaclock.cfg.style.date})},
+    {"style text", cmd_style("style text", OB::Color::Type::fg, {&_ctx.style.text})},
+    {"style background", cmd_style("style background", OB::Color::Type::bg, {&_ctx.style.background, &_peaclock.cfg.style.background})},
+    {"style prompt", cmd_style("style prompt", OB::Color::Type::fg, {&_ctx.style.prompt})},
+    {"style success", cmd_style("style success", OB::Color::Type::fg, {&_ctx.style.success})},
+    {"style error", cmd_style("style error", OB::Color::Type::fg, {&_ctx.style.error})},
+
+    {"set date", cmd_bool("set date", _peaclock.cfg.date)},
+    {"set seconds", cmd_bool("set seconds", _peaclock.cfg.seconds)},
+    {"set hour-24", cmd_bool("set hour-24", _peaclock.cfg.hour_24)},
+    {"set auto-size", cmd_bool("set auto-size", _peaclock.cfg.auto_size)},
+    {"set auto-ratio", cmd_bool("set auto-ratio", _peaclock.cfg.auto_ratio)},
+    {"set damage", cmd_bool("set damage", _ctx.damage)},
+    {"set sync", cmd_bool("set sync", _ctx.sync)},
+  };
+
+  // aliases
+  for (auto const& [alias, name] : std::initializer_list<std::pair<std::string_view, std::string_view>> {
+    {"Q", "q"}, {"quit", "q"}, {"Quit", "q"}, {"exit", "q"},
+    {"h", "help"},
+    {"mkconfig!", "mkconfig"},
+  })
   {
-    if ((match_opt = OB::String::match(input,
-            std::regex("^set\\s+date(?:\\s+(true|false|t|f|1|0|on|off))?$"))))
-    {
-      auto const match = match_opt.value().at(1);
+    _commands.emplace(alias, _commands.at(name));
+  }
+}
 
-      if (match.empty())
-      {
-        return std::make_pair(true, "set date "s + btos(_peaclock.cfg.date));
-      }
-      else if ("true" == match || "t" == match || "1" == match || "on" == match)
-      {
-        _peaclock.cfg.date = true;
-      }
-      else
-      {
-        _peaclock.cfg.date = false;
-      }
-    }
+Tui::Parsed Tui::parse(std::string_view const input)
+{
+  Parsed parsed;
+  Args args;
 
-    else if ((match_opt = OB::String::match(input,
-            std::regex("^set\\s+seconds(?:\\s+(true|false|t|f|1|0|on|off))?$"))))
+  if (args.parse(input) && ! args.word.empty())
+  {
+    // single word command
+    if (auto const it = _commands.find(args.word.at(0)); it != _commands.end())
     {
-      auto const match = match_opt.value().at(1);
-
-      if (match.empty())
-      {
-        return std::make_pair(true, "set seconds "s + btos(_peaclock.cfg.seconds));
-      }
-      else if ("true" == match || "t" == match || "1" == match || "on" == match)
-      {
-        _peaclock.cfg.seconds = true;
-      }
-      else
-      {
-        _peaclock.cfg.seconds = false;
-      }
+      parsed = it->second(args);
     }
 
-    else if ((match_opt = OB::String::match(input,
-            std::regex("^set\\s+hour-24(?:\\s+(true|false|t|f|1|0|on|off))?$"))))
+    // two word command, such as 'set' and 'style'
+    else if (args.word.size() > 1)
     {
-      auto const match = match_opt.value().at(1);
+      std::string name {args.word.at(0)};
+      name += " ";
+      name += args.word.at(1);
 
-      if (match.empty())
-      {
-        return std::make_pair(true, "set hour-24 "s + btos(_peaclock.cfg.hour_24));
-      }
-      else if ("true" == match || "t" == match || "1" == match || "on" == match)
+      if (auto const pair = _commands.find(name); pair != _commands.end())
       {
-        _peaclock.cfg.hour_24 = true;
-      }
-      else
-      {
-        _peaclock.cfg.hour_24 = false;
+        parsed = pair->second(args);
       }
     }
+  }
 
-    else if ((match_opt = OB::String::match(input,
-            std::regex("^set\\s+auto-size(?:\\s+(true|false|t|f|1|0|on|off))?$"))))
-    {
-      auto const match = match_opt.value().at(1);
-
-      if (match.empty())
-      {
-        return std::make_pair(true, "set auto-size "s + btos(_peaclock.cfg.auto_size));
-      }
-      else if ("true" == match || "t" == match || "1" == match || "on" == match)
-      {
-        _peaclock.cfg.auto_size = true;
-      }
-      else
-      {
-        _peaclock.cfg.auto_size = false;
-      }
-    }
+  // unknown
+  if (! parsed.action && ! parsed.status)
+  {
+    parsed.status = std::make_pair(false, "warning: unknown command '" + std::string(input) + "'");
+  }
 
-    else if ((match_opt = OB::String::match(input,
-            std::regex("^set\\s+auto-ratio(?:\\s+(true|false|t|f|1|0|on|off))?$"))))
-    {
-      auto const match = match_opt.value().at(1);
+  return parsed;
+}
 
-      if (match.empty())
-      {
-        return std::make_pair(true, "set auto-ratio "s + btos(_peaclock.cfg.auto_ratio));
-      }
-      else if ("true" == match || "t" == match || "1" == match || "on" == match)
-      {
-        _peaclock.cfg.auto_ratio = true;
-      }
-      else
-      {
-        _peaclock.cfg.auto_ratio = false;
-      }
-    }
+std::optional<std::pair<bool, std::string>> Tui::command(std::string const& input)
+{
+  // quit
+  if (! _ctx.is_running)
+  {
+    _ctx.is_running = false;
+    return {};
+  }
 
-    else
-    {
-      return std::make_pair(false, "warning: unknown command '" + input + "'");
-    }
+  // nop
+  if (input.empty())
+  {
+    return {};
   }
 
-  // unknown
-  else
+  auto const parsed = parse(input);
+
+  if (! parsed.action)
   {
-    return std::make_pair(false, "warning: unknown command '" + input + "'");
+    return parsed.status;
   }
 
-  return {};
+  return parsed.action();
 }
 
 void Tui::command_prompt()
 {
   // reset prompt message count
-  _ctx.prompt.count = 0;
+  _ctx.prompt.expire = {};
 
   // set prompt style
   _readline.style(_ctx.style.text.value() + _ctx.style.background.value());
   _readline.prompt(":", _ctx.style.prompt.value() + _ctx.style.background.value());
 
+  // queued frames are written before the prompt is drawn over them
+  _ctx.out.drain(_ctx.tty);
+
   std::cout
   << aec::cursor_save
   << aec::cursor_set(0, _ctx.height)
@@ -2415,6 +2464,9 @@ void Tui::command_prompt()
   << aec::cursor_load
   << std::flush;
 
+  // the prompt was drawn outside of the framebuffer
+  _ctx.prev.invalidate();
+
   if (auto const res = command(input))
   {
     set_status(res.value().first, res.value().second);
@@ -2430,13 +2482,11 @@ int Tui::screen_size()
   {
     clear();
 
-    _ctx.buf
-    << _ctx.style.background
-    << _ctx.style.error;
+    std::ostringstream err;
 
     if (width_invalid && height_invalid)
     {
-      _ctx.buf
+      err
       << "Error: width "
       << _ctx.width
       << " (min "
@@ -2449,7 +2499,7 @@ int Tui::screen_size()
     }
     else if (width_invalid)
     {
-      _ctx.buf
+      err
       << "Error: width "
       << _ctx.width
       << " (min "
@@ -2458,7 +2508,7 @@ int Tui::screen_size()
     }
     else
     {
-      _ctx.buf
+      err
       << "Error: height "
       << _ctx.height
       << " (min "
@@ -2466,8 +2516,15 @@ int Tui::screen_size()
       << ")";
     }
 
-    _ctx.buf
-    << aec::clear;
+    // wrap the message over the available rows
+    auto const str = err.str();
+    auto const fg = _ctx.buf.style(_ctx.style.error);
+    auto const bg = _ctx.buf.style(_ctx.style.background);
+
+    for (std::size_t y = 0; y < _ctx.height && y * _ctx.width < str.size(); ++y)
+    {
+      _ctx.buf.text(0, y, std::string_view(str).substr(y * _ctx.width, _ctx.width), fg, bg);
+    }
 
     refresh();
 
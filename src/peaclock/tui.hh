@@ -9,6 +9,8 @@ using Parg = OB::Parg;
 #include "ob/num.hh"
 #include "ob/color.hh"
 #include "ob/readline.hh"
+#include "ob/framebuffer.hh"
+#include "ob/sink.hh"
 #include "ob/string.hh"
 #include "ob/text.hh"
 #include "ob/term.hh"
@@ -20,10 +22,15 @@ namespace aec = OB::Term::ANSI_Escape_Codes;
 #include <cstdlib>
 
 #include <string>
+#include <string_view>
 #include <vector>
+#include <chrono>
 #include <sstream>
+#include <iostream>
 #include <utility>
 #include <optional>
+#include <functional>
+#include <unordered_map>
 
 #include <filesystem>
 namespace fs = std::filesystem;
@@ -36,18 +43,74 @@ public:
 
   Tui& init(fs::path const& path = {});
   void base_config(fs::path const& path);
-  void load_config(fs::path const& path);
-  void load_hist_command(fs::path const& path);
+  // returns false when the config had errors, the user is asked to
+  // continue unless prompt is false
+  bool load_config(fs::path const& path, bool const prompt = true);
+  void load_hist_command(fs::path const& path, bool const save = true);
   void run();
 
+  // draw a frame of the given size without writing it to the terminal
+  void render(std::size_t const width, std::size_t const height);
+
+  // write the frame drawn since the previous flush to a file descriptor,
+  // optionally wrapped in a synchronized update
+  void flush(int const fd, bool const sync = false);
+
+  // bytes written per frame
+  OB::Sink::Stats const& stats() const;
+
 private:
 
   void get_input();
   bool press_to_continue(std::string const& str = "ANY KEY", char32_t val = 0);
 
+  // result of a command, whether it succeeded and a status message
+  using Status = std::optional<std::pair<bool, std::string>>;
+
+  // applies a parsed command
+  using Action = std::function<Status()>;
+
+  // command input split into words,
+  // a quoted string is a single word that keeps its quotes
+  struct Args
+  {
+    // split the line, returns false on an unterminated or misplaced quote
+    bool parse(std::string_view const str);
+
+    // the remainder of the line starting at word i
+    std::string_view rest(std::size_t const i) const;
+
+    std::string_view line;
+    std::vector<std::string_view> word;
+  };
+
+  // a parsed command, the action is set when the arguments are valid,
+  // otherwise the status may hold an error
+  struct Parsed
+  {
+    Action action {};
+    Status status {};
+  };
+
+  // parses the arguments of a command
+  using Parser = std::function<Parsed(Args const&)>;
+
+  void init_commands();
+  Parsed parse(std::string_view const input);
   std::optional<std::pair<bool, std::string>> command(std::string const& input);
   void command_prompt();
 
+  enum class Event
+  {
+    none,
+    timeout,
+    input,
+    resize,
+    output,
+  };
+
+  Event wait_event(int const timeout);
+  int redraw_wait();
   void event_loop();
   int screen_size();
 
@@ -63,6 +126,9 @@ private:
 
   bool mkconfig(std::string path, bool overwrite = false);
 
+  // command name to argument parser
+  std::unordered_map<std::string_view, Parser> _commands;
+
   Parg const& _pg;
   bool const _colorterm;
   OB::Term::Mode _term_mode;
@@ -82,18 +148,46 @@ private:
     std::size_t width_min {4};
     std::size_t height_min {2};
 
-    // output buffer
-    std::ostringstream buf;
+    // off-screen cells the current frame is drawn into
+    OB::Framebuffer buf;
+
+    // cells on the terminal screen after the previous frame
+    OB::Framebuffer prev;
+
+    // escape sequences written to the terminal
+    OB::Sink out;
+
+    // only output the cells that changed since the previous frame
+    bool damage {true};
+
+    // wrap each frame in a synchronized update when the terminal supports it
+    bool sync {true};
+
+    // whether the terminal supports synchronized updates, queried on first use
+    std::optional<bool> sync_support;
 
     // control when to exit the event loop
     bool is_running {true};
 
+    // self-pipe written to on SIGWINCH
+    int sigwinch[2] {-1, -1};
+
+    // nonblocking descriptor of the terminal that frames are written to,
+    // a frame drawn while an earlier one is still queued is dropped
+    int tty {STDOUT_FILENO};
+
+    // a frame was dropped, draw a new one once the queue empties
+    bool stale {false};
+
     // interval between reading a keypress
     OB::num input_interval {50, 10, 1000};
 
     // total time spent in input loop
     OB::num refresh_rate {1000, 10, 60000};
 
+    // interval between frames of a stopwatch showing fractions of a second
+    OB::num fraction_rate {10, 1, 1000};
+
     // input key buffers
     OB::Text::Char32 key;
     std::vector<OB::Text::Char32> keys;
@@ -102,11 +196,13 @@ private:
     struct Prompt
     {
       std::string str;
-      int count {0};
-      int timeout {0};
+      std::chrono::steady_clock::time_point expire;
       OB::num rate {5000, 0, 60000};
     } prompt;
 
+    // time of the previous redraw
+    std::chrono::steady_clock::time_point drawn;
+
     struct Style
     {
       OB::Color text {"", OB::Color::Type::fg};
@@ -119,13 +215,6 @@ private:
       // stores success or error color for status output
       OB::Color prompt_status {"", OB::Color::Type::fg};
     } style;
-
-    struct Regex
-    {
-      std::string const str_s {"(?:'[^'\\\\]*(?:\\\\.[^'\\\\]*)*')"};
-      std::string const str_d {"(?:\"[^\\\"\\\\]*(?:\\\\.[^\\\"\\\\]*)*\")"};
-      std::string const str {"(?:" + str_s + "|" + str_d + ")"};
-    } rx;
   } _ctx;
 };
 